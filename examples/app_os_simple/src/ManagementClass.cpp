@@ -31,6 +31,7 @@ const char *ManagementClass::STATES_NAMES[States_Total] = {
 };
 
 static const int MIX_TANK_EMPTY_CNT_MAX = 2;
+static const float MIX_WEIGHT_DEADBAND = 1.0f;      // gram
 
 ManagementClass::ManagementClass(TaskHandle_t taskHandle)
     : FwObject("man"),
@@ -41,6 +42,7 @@ ManagementClass::ManagementClass(TaskHandle_t taskHandle)
     epochMarker_ = 0;
     stateSwitchedLast_ = 0;
     mix_gram_ = 0;
+    mixWeight_ = 0;
     shortWateringCnt_ = 0;
     for (int i = 0; i < 2*WEIGHT_PERIOD_LENGTH; i++) {
         lastGram_[i] = 0;
@@ -58,6 +60,50 @@ void ManagementClass::PostInit() {
         iface->registerKeyListener(
             static_cast<KeyListenerInterface *>(this));
     }
+
+    usrset_.RequestToService.bind("usrset", "RequestToService");
+    usrset_.WateringInterval.bind("usrset", "WateringInterval");
+    usrset_.WateringPerDrain.bind("usrset", "WateringPerDrain");
+    usrset_.OxygenSaturationInterval.bind("usrset", "OxygenSaturationInterval");
+    usrset_.WateringDuration.bind("usrset", "WateringDuration");
+    usrset_.LastWatering.bind("usrset", "LastWatering");
+    usrset_.LastServiceTime.bind("usrset", "LastServiceTime");
+    usrset_.LastServiceDate.bind("usrset", "LastServiceDate");
+    usrset_.State.bind("usrset", "State");
+    usrset_.DayStart.bind("usrset", "DayStart");
+    usrset_.DayEnd.bind("usrset", "DayEnd");
+    usrset_.DayDuty[0].bind("usrset", "DayDuty0");
+    usrset_.DayDuty[1].bind("usrset", "DayDuty1");
+    usrset_.DayDuty[2].bind("usrset", "DayDuty2");
+    usrset_.DayDuty[3].bind("usrset", "DayDuty3");
+    rtcTime_.bind("rtc", "Time");
+    rtcDate_.bind("rtc", "Date");
+    uledState_.bind("uled0", "state");
+    lightsDuty_.bind("hbrg2", "dc1_duty");
+    oxyPumpDuty_.bind("hbrg2", "dc0_duty");
+    drainPumpDuty_.bind("hbrg0", "dc0_duty");
+    highPressurePump_.bind("relais0", "State");
+    relaisLight_.bind("relais1", "State");
+    ledDuty_[0].bind("ledrbw", "duty0");
+    ledDuty_[1].bind("ledrbw", "duty1");
+    ledDuty_[2].bind("ledrbw", "duty2");
+    ledDuty_[3].bind("ledrbw", "duty3");
+    mixGram_.bind("scales", "gram2");
+    moisture_.bind("soil0", "moisture");
+
+    // Weight is pushed by the scales driver instead of polling
+    if (mixGram_.isBound()) {
+        mixWeight_ = mixGram_.read();
+        mixGram_.attribute()->registerListener(
+            static_cast<AttributeListenerInterface *>(this),
+            MIX_WEIGHT_DEADBAND);
+    }
+}
+
+void ManagementClass::attributeChanged(FwAttribute *attr) {
+    if (attr == mixGram_.attribute()) {
+        mixWeight_ = attr->to_float();
+    }
 }
 
 
@@ -69,8 +115,8 @@ void ManagementClass::update() {
 
     updateMixWeight();
 
-    if (btnClick || read_int8("usrset", "RequestToService")) {
-        write_int8("usrset", "RequestToService", 0);
+    if (btnClick || usrset_.RequestToService.read()) {
+        usrset_.RequestToService.write(0);
         if (estate_ != Servicing) {
             switchToService();
         } else {
@@ -86,8 +132,8 @@ void ManagementClass::update() {
         }
         break;
     case CheckWateringInterval:
-        if (isPeriodExpired(read_uint16("usrset", "WateringInterval"))) {
-            if (read_int8("usrset", "WateringPerDrain") > 1) {
+        if (isPeriodExpired(usrset_.WateringInterval.read())) {
+            if (usrset_.WateringPerDrain.read() > 1) {
                 if (shortWateringCnt_ == 0) {
                     switchToState(OxygenSaturation);
                     enableOxyPump();
@@ -111,9 +157,9 @@ void ManagementClass::update() {
         }
         break;
     case OxygenSaturation:
-        if (isPeriodExpired(read_uint16("usrset", "OxygenSaturationInterval"))) {
+        if (isPeriodExpired(usrset_.OxygenSaturationInterval.read())) {
             switchToState(Watering);
-            write_uint32("usrset", "LastWatering", read_uint32("rtc", "Time"));
+            usrset_.LastWatering.write(rtcTime_.read());
             disableOxyPump();
             enableHighPressurePump();
         }
@@ -122,7 +168,7 @@ void ManagementClass::update() {
         // Watering rate ~14 gram/sec
         if (isWateringEnd()) {
             disableHighPressurePump();
-            if (++shortWateringCnt_ >= read_int8("usrset", "WateringPerDrain")) {
+            if (++shortWateringCnt_ >= usrset_.WateringPerDrain.read()) {
                 switchToState(DrainAfter);
                 enableDrainPump();
                 shortWateringCnt_ = 0;
@@ -145,7 +191,7 @@ void ManagementClass::update() {
 
     case Servicing:
         // Do nothing
-        write_int8("uled0", "state", static_cast<int8_t>(epochCnt_ & 0x1));
+        uledState_.write(static_cast<int8_t>(epochCnt_ & 0x1));
         break;
     default:
         estate_ = WaitInit;
@@ -209,7 +255,7 @@ bool ManagementClass::isDrainEnd() {
 
 bool ManagementClass::isWateringEnd() {
     int deltaGram = 0;
-    if (isPeriodExpired(read_uint16("usrset", "WateringDuration"))) {
+    if (isPeriodExpired(usrset_.WateringDuration.read())) {
         // 240 sec * 14 = 3360 grams of water
         return true;
     }
@@ -229,7 +275,7 @@ bool ManagementClass::isWateringEnd() {
         // no water in mix tank
         uart_printf("[%d] Mix tank is empty\r\n", xTaskGetTickCount());
         // to switch to DrainAfter state
-        shortWateringCnt_ = read_int8("usrset", "WateringPerDrain");
+        shortWateringCnt_ = usrset_.WateringPerDrain.read();
         return true;
     }
     return false;
@@ -253,7 +299,7 @@ void ManagementClass::switchToState(EState newstate) {
 
     stateSwitchedLast_ = epochMarker_;
     estate_ = newstate;
-    write_int8("usrset", "State", static_cast<int8_t>(newstate));
+    usrset_.State.write(static_cast<int8_t>(newstate));
 }
 
 void ManagementClass::switchToService() {
@@ -261,173 +307,102 @@ void ManagementClass::switchToService() {
     disableHighPressurePump();  // watering
     disableDrainPump();         // sewer
     disableOxyPump();           // oxygen
-    write_int8("hbrg2", "dc1_duty", 0); // lights up/down
-    write_int8("uled0", "state", 0);
-    write_uint32("usrset", "LastServiceTime", read_uint32("rtc", "Time"));
-    write_uint32("usrset", "LastServiceDate", read_uint32("rtc", "Date"));
-    write_int8("usrset", "State", static_cast<int8_t>(Servicing));
+    lightsDuty_.write(0); // lights up/down
+    uledState_.write(0);
+    usrset_.LastServiceTime.write(rtcTime_.read());
+    usrset_.LastServiceDate.write(rtcDate_.read());
+    usrset_.State.write(static_cast<int8_t>(Servicing));
     estate_ = Servicing;
     uart_printf("[%d] Switching to Service\r\n", xTaskGetTickCount());
 }
 
 void ManagementClass::switchToNormal() {
     estate_ = normal_.estate;
-    write_int8("uled0", "state", 1);
-    write_int8("usrset", "State", static_cast<int8_t>(normal_.estate));
+    uledState_.write(1);
+    usrset_.State.write(static_cast<int8_t>(normal_.estate));
     uart_printf("[%d] Switching to Normal\r\n", xTaskGetTickCount());
 }
 
 void ManagementClass::setDayLights(uint32_t tow) {
-    uint32_t dayStart = read_uint32("usrset", "DayStart");
-    uint32_t dayEnd = read_uint32("usrset", "DayEnd");
+    uint32_t dayStart = usrset_.DayStart.read();
+    uint32_t dayEnd = usrset_.DayEnd.read();
     if (tow < dayStart || tow > dayEnd) {
-        write_int8("ledrbw", "duty0", 0);   // blue
-        write_int8("ledrbw", "duty1", 0);   // ventilation
-        write_int8("ledrbw", "duty2", 0);   // white
-        write_int8("ledrbw", "duty3", 0);   // red/blue
+        ledDuty_[0].write(0);   // blue
+        ledDuty_[1].write(0);   // ventilation
+        ledDuty_[2].write(0);   // white
+        ledDuty_[3].write(0);   // red/blue
         disableRelaisLight();
     } else if (tow >= dayStart && tow < (dayStart + 30*60)) {
         // sunrise 30 minutes
         float dt = static_cast<float>(tow - dayStart)/ 1800.0f;
-        write_int8("ledrbw", "duty0", 
-            static_cast<int8_t>(dt * read_int8("usrset", "DayDuty0")));   // blue
-        //write_int8("ledrbw", "duty1",
-        //    static_cast<int8_t>(dt * read_int8("usrset", "DayDuty1")));   // unused
-        write_int8("ledrbw", "duty2",
+        ledDuty_[0].write(
+            static_cast<int8_t>(dt * usrset_.DayDuty[0].read()));   // blue
+        //ledDuty_[1].write(
+        //    static_cast<int8_t>(dt * usrset_.DayDuty[1].read()));   // unused
+        ledDuty_[2].write(
             static_cast<int8_t>(dt * 90));   // white
-        write_int8("ledrbw", "duty3",
-            static_cast<int8_t>(dt * read_int8("usrset", "DayDuty3")));   // red/blue
+        ledDuty_[3].write(
+            static_cast<int8_t>(dt * usrset_.DayDuty[3].read()));   // red/blue
     } else if (tow >= (dayEnd - 30*60) && tow < dayEnd) {
         // sunset 30 minutes
         float dt = 1.0f - static_cast<float>(tow - (dayEnd - 1800))/ 1800.0f;
-        write_int8("ledrbw", "duty0", 
-            static_cast<int8_t>(dt * read_int8("usrset", "DayDuty0")));   // blue
-        //write_int8("ledrbw", "duty1",
-        //    static_cast<int8_t>(dt * read_int8("usrset", "DayDuty1")));   // unused
-        write_int8("ledrbw", "duty2",
+        ledDuty_[0].write(
+            static_cast<int8_t>(dt * usrset_.DayDuty[0].read()));   // blue
+        //ledDuty_[1].write(
+        //    static_cast<int8_t>(dt * usrset_.DayDuty[1].read()));   // unused
+        ledDuty_[2].write(
             static_cast<int8_t>(dt * 90));   // white
-        write_int8("ledrbw", "duty3",
-            static_cast<int8_t>(dt * read_int8("usrset", "DayDuty3")));   // red/blue
+        ledDuty_[3].write(
+            static_cast<int8_t>(dt * usrset_.DayDuty[3].read()));   // red/blue
         disableRelaisLight();
     } else {
-        write_int8("ledrbw", "duty0", read_int8("usrset", "DayDuty0"));   // blue
-        write_int8("ledrbw", "duty1", read_int8("usrset", "DayDuty1"));   // ventilation
-        write_int8("ledrbw", "duty2", read_int8("usrset", "DayDuty2"));   // white
-        write_int8("ledrbw", "duty3", read_int8("usrset", "DayDuty3"));   // red/blue
+        ledDuty_[0].write(usrset_.DayDuty[0].read());   // blue
+        ledDuty_[1].write(usrset_.DayDuty[1].read());   // ventilation
+        ledDuty_[2].write(usrset_.DayDuty[2].read());   // white
+        ledDuty_[3].write(usrset_.DayDuty[3].read());   // red/blue
         enableRelaisLight();
     }
 }
 
 void ManagementClass::enableHighPressurePump() {
-    write_int8("relais0", "State", 1);
+    highPressurePump_.write(1);
 }
 
 void ManagementClass::disableHighPressurePump() {
-    write_int8("relais0", "State", 0);
+    highPressurePump_.write(0);
 }
 
 void ManagementClass::enableRelaisLight() {
-    write_int8("relais1", "State", 1);
+    relaisLight_.write(1);
 }
 
 void ManagementClass::disableRelaisLight() {
-    write_int8("relais1", "State", 0);
+    relaisLight_.write(0);
 }
 
 
 void ManagementClass::enableDrainPump() {
-    write_int8("hbrg0", "dc0_duty", 100);
+    drainPumpDuty_.write(100);
 }
 
 void ManagementClass::disableDrainPump() {
-    write_int8("hbrg0", "dc0_duty", 0);
+    drainPumpDuty_.write(0);
 }
 
 void ManagementClass::enableOxyPump() {
-    write_int8("hbrg2", "dc0_duty", 100);
+    oxyPumpDuty_.write(100);
 }
 
 void ManagementClass::disableOxyPump() {
-    write_int8("hbrg2", "dc0_duty", 0);
-}
-
-void ManagementClass::write_obj_attribute(const char *objname,
-                         const char *atrname,
-                         char *buf,
-                         int sz) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        atr->write(buf, sz, false);
-    } else {
-        uart_printf("[%d] %s:%s not found\r\n",
-            xTaskGetTickCount(), objname, atrname);
-    }
-}
-
-void ManagementClass::write_int8(const char *objname,
-                                const char *atrname,
-                                int8_t v) {
-    char buf[2] = {static_cast<char>(v), 0};
-    write_obj_attribute(objname, atrname, buf, 1);
-}
-
-void ManagementClass::write_uint32(const char *objname,
-                                   const char *atrname,
-                                   uint32_t v) {
-    char buf[5] = {static_cast<char>(v),
-                   static_cast<char>(v >> 8),
-                   static_cast<char>(v >> 16),
-                   static_cast<char>(v >> 24)};
-    write_obj_attribute(objname, atrname, buf, 4);
-}
-
-int8_t ManagementClass::read_int8(const char *objname,
-                                   const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_int8();
-    }
-    return 0;
-}
-
-uint16_t ManagementClass::read_uint16(const char *objname,
-                                      const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_uint16();
-    }
-    return 0;
-}
-
-uint32_t ManagementClass::read_uint32(const char *objname,
-                                      const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_uint32();
-    }
-    return 0;
-}
-
-float ManagementClass::read_float32(const char *objname,
-                                    const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_float();
-    }
-    return 0;
+    oxyPumpDuty_.write(0);
 }
 
 float ManagementClass::getMixWeight() {
-    return read_float32("scales", "gram2");
+    return mixWeight_;
 }
 
 uint16_t ManagementClass::getMoisture() {
-    return read_uint16("soil0", "moisture");
+    return moisture_.read();
 }
 
 uint32_t ManagementClass::getTimeOfDay() {
@@ -442,7 +417,7 @@ uint32_t ManagementClass::getTimeOfDay() {
     // [7] resered
     // [6:4] Seconds tens in BCD format
     // [3:0] Seconds units in BCD format
-    uint32_t rtc_time = read_uint32("rtc", "Time");
+    uint32_t rtc_time = rtcTime_.read();
     tow = ((rtc_time >> 20) & 0x3) * 10 * 3600; // seconds
     tow += ((rtc_time >> 16) & 0xF) * 3600;
     tow += ((rtc_time >> 12) & 0x7) * 10 * 60;
@@ -17,11 +17,14 @@
 #include <prjtypes.h>
 #include <fwobject.h>
 #include <fwattribute.h>
+#include <fwattrref.h>
 #include <KeyInterface.h>
+#include <AttributeInterface.h>
 #include <task.h>
 
 class ManagementClass : public FwObject,
-                        public KeyListenerInterface {
+                        public KeyListenerInterface,
+                        public AttributeListenerInterface {
  public:
     ManagementClass(TaskHandle_t taskHandle);
 
@@ -36,6 +39,9 @@ class ManagementClass : public FwObject,
     virtual void keyDoubleClick() override {}
     virtual void keyLongClick() override {}
 
+    // AttributeListenerInterface
+    virtual void attributeChanged(FwAttribute *attr) override;
+
  public:
     void update();
 
@@ -70,24 +76,6 @@ class ManagementClass : public FwObject,
     void disableOxyPump();
 
     void waitKeyPressed();
-    void write_obj_attribute(const char *objname,
-                             const char *atrname,
-                             char *buf,
-                             int sz);
-    void write_int8(const char *objname,
-                    const char *atrname,
-                    int8_t v);
-    void write_uint32(const char *objname,
-                      const char *atrname,
-                      uint32_t v);
-    int8_t read_int8(const char *objname,
-                     const char *atrname);
-    uint16_t read_uint16(const char *objname,
-                        const char *atrname);
-    uint32_t read_uint32(const char *objname,
-                         const char *atrname);
-    float read_float32(const char *objname,
-                         const char *atrname);
 
     float getMixWeight();
     uint16_t getMoisture();
@@ -112,5 +100,33 @@ class ManagementClass : public FwObject,
     } normal_;
 
     float mix_gram_;
+    volatile float mixWeight_;     // pushed by scales:gram2 subscription
     int8_t shortWateringCnt_;      // Watering count before drain enabled
+
+    // Attributes of other objects bound in PostInit()
+    struct UserSettingsRefs {
+        FwAttrRef<int8_t> RequestToService;
+        FwAttrRef<uint16_t> WateringInterval;
+        FwAttrRef<int8_t> WateringPerDrain;
+        FwAttrRef<uint16_t> OxygenSaturationInterval;
+        FwAttrRef<uint16_t> WateringDuration;
+        FwAttrRef<uint32_t> LastWatering;
+        FwAttrRef<uint32_t> LastServiceTime;
+        FwAttrRef<uint32_t> LastServiceDate;
+        FwAttrRef<int8_t> State;
+        FwAttrRef<uint32_t> DayStart;
+        FwAttrRef<uint32_t> DayEnd;
+        FwAttrRef<int8_t> DayDuty[4];
+    } usrset_;
+    FwAttrRef<uint32_t> rtcTime_;
+    FwAttrRef<uint32_t> rtcDate_;
+    FwAttrRef<int8_t> uledState_;
+    FwAttrRef<int8_t> lightsDuty_;          // hbrg2:dc1_duty lights up/down
+    FwAttrRef<int8_t> oxyPumpDuty_;         // hbrg2:dc0_duty
+    FwAttrRef<int8_t> drainPumpDuty_;       // hbrg0:dc0_duty
+    FwAttrRef<int8_t> highPressurePump_;    // relais0:State
+    FwAttrRef<int8_t> relaisLight_;         // relais1:State
+    FwAttrRef<int8_t> ledDuty_[4];          // ledrbw:duty0..3
+    FwAttrRef<float> mixGram_;              // scales:gram2
+    FwAttrRef<uint16_t> moisture_;          // soil0:moisture
 };
@@ -20,9 +20,22 @@
 #include <task.h>
 #include <timers.h>
 #include <semphr.h>
+#include <TimerInterface.h>
 
-#define APP_TASK_NAME "app"
+/** Deferred interrupt work task name */
+#define APP_WORK_TASK_NAME "work"
+/** Lowest priority application task name */
+#define APP_EPOCH_TASK_NAME "epoch"
+
+/** Timer service slots reserved for the one-shot timers */
+#define APP_TIMERS_ONESHOT_MAX 4
+
+/** Timer service task names per EFwExecClass */
+static const char *const APP_EXEC_TASK_NAME[FW_EXEC_CLASSES_TOTAL] = {
+    "rt", "sensor", "comms", "bg"
+};
 
 
 portTASK_FUNCTION(task1ms, args);
 portTASK_FUNCTION(taskEpoch, args);
+portTASK_FUNCTION(taskWork, args);
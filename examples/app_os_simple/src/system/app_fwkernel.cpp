@@ -20,35 +20,36 @@
 #include <string.h>
 #include <new>
 
+#define APP_OBJECT_ENTRY(type, member, name, ...) \
+    FW_STATIC_ENTRY(AppKernelClass, member, name),
+
+FW_STATIC_TABLE_BEGIN
+const FwStaticEntry AppKernelClass::OBJECTS[] = {
+    {FW_HASH("kernel"), 0},
+    KERNEL_GENERIC_OBJECTS(APP_OBJECT_ENTRY)
+    APP_KERNEL_OBJECTS(APP_OBJECT_ENTRY)
+};
+FW_STATIC_TABLE_END
+
+const int AppKernelClass::OBJECTS_TOTAL = FW_STATIC_TABLE_SIZE(OBJECTS);
+
 /**
  * @brief Kernel module constructor. Instance of this KernelClass registered
  *        as the first element in the single linked list of FwObjects.
  */
-AppKernelClass::AppKernelClass(const char *name) : KernelClassGeneric(name),
-    uart1_("uart1"),
-    rtc_("rtc"),
-    relais0_("relais0", 0),
-    relais1_("relais1", 1),
-    ledrbw_("ledrbw"),
-    can1_("can1", 0),
-    can2_("can2", 1),
-    scales_("scales"),
-    uled0_("uled0"),
-    ubtn0_("ubtn0"),
-    adc1_("adc1"),
-    hbrg0_("hbrg0", 0),
-    hbrg1_("hbrg1", 1),
-    hbrg2_("hbrg2", 2),
-    hbrg3_("hbrg3", 3),
-    temp0_("temp0"),
-    soil0_("soil0"),
-    settings_("usrset")
+AppKernelClass::AppKernelClass(const char *name) : KernelClassGeneric(name)
+    APP_KERNEL_OBJECTS(FW_STATIC_INIT)
 {
     version_.make_uint32(0x20240804);
     output_.make_int32(0);
 }
 
 extern "C" void kernel_init() {
-    new (fw_malloc(sizeof(AppKernelClass))) AppKernelClass("kernel");
+    void *kernel = fw_malloc(sizeof(AppKernelClass));
+    fw_register_static_objects(kernel,
+                               sizeof(AppKernelClass),
+                               AppKernelClass::OBJECTS,
+                               AppKernelClass::OBJECTS_TOTAL);
+    new (kernel) AppKernelClass("kernel");
 }
 
@@ -28,6 +28,42 @@
 #include "ds18b20_drv.h"
 #include "soil_drv.h"
 #include "usrsettings.h"
+#include "memstat.h"
+#include "pwrstat.h"
+#include "profiler.h"
+#include "tracer.h"
+
+/** CAN receive ring depth per bus */
+#define APP_CAN_RX_FRAMES 32
+
+/**
+ * @brief Kernel objects in DBC index order after the generic ones. Items
+ *        X(type, member, name, ...) are expanded into the members, their
+ *        constructor calls and the static table (see FW_STATIC_MEMBER).
+ */
+#define APP_KERNEL_OBJECTS(X) \
+    X(UartDriver, uart1_, "uart1") \
+    X(RtcDriver, rtc_, "rtc") \
+    X(RelaisDriver, relais0_, "relais0", 0) \
+    X(RelaisDriver, relais1_, "relais1", 1) \
+    X(LedStripDriver, ledrbw_, "ledrbw") \
+    X(CanDriver, can1_, "can1", 0, APP_CAN_RX_FRAMES) \
+    X(CanDriver, can2_, "can2", 1, APP_CAN_RX_FRAMES) \
+    X(LoadSensorDriver, scales_, "scales") \
+    X(UserLedDriver, uled0_, "uled0") \
+    X(UserButtonDriver, ubtn0_, "ubtn0") \
+    X(AdcDriver, adc1_, "adc1") \
+    X(HBridgeDriver, hbrg0_, "hbrg0", 0) \
+    X(HBridgeDriver, hbrg1_, "hbrg1", 1) \
+    X(HBridgeDriver, hbrg2_, "hbrg2", 2) \
+    X(HBridgeDriver, hbrg3_, "hbrg3", 3) \
+    X(Ds18b20Driver, temp0_, "temp0") \
+    X(SoilDriver, soil0_, "soil0") \
+    X(UserSettings, settings_, "usrset") \
+    X(MemoryStatDriver, mem_, "mem") \
+    X(PowerStatDriver, pwr_, "pwr") \
+    X(ProfilerDriver, prof_, "prof") \
+    X(TraceDriver, trace_, "trace")
 
 class AppKernelClass : public KernelClassGeneric {
  public:
@@ -36,24 +72,10 @@ class AppKernelClass : public KernelClassGeneric {
     // FwObject interface:
     //virtual void PostInit() override;
 
+    /** @brief Flash resident table of the kernel objects in DBC index order */
+    static const FwStaticEntry OBJECTS[];
+    static const int OBJECTS_TOTAL;
+
  private:
-    /** @brief Kernel Version attribute */
-    UartDriver uart1_;
-    RtcDriver rtc_;
-    RelaisDriver relais0_;
-    RelaisDriver relais1_;
-    LedStripDriver ledrbw_;
-    CanDriver can1_;
-    CanDriver can2_;
-    LoadSensorDriver scales_;
-    UserLedDriver uled0_;
-    UserButtonDriver ubtn0_;
-    AdcDriver adc1_;
-    HBridgeDriver hbrg0_;
-    HBridgeDriver hbrg1_;
-    HBridgeDriver hbrg2_;
-    HBridgeDriver hbrg3_;
-    Ds18b20Driver temp0_;
-    SoilDriver soil0_;
-    UserSettings settings_;
+    APP_KERNEL_OBJECTS(FW_STATIC_MEMBER)
 };
@@ -22,11 +22,15 @@ extern "C"
 #endif
 
 extern void Btn_IRQHandler();
+extern void CAN1_TX_irq_handler();
 extern void CAN1_FIFO0_irq_handler();
 extern void CAN1_FIFO1_irq_handler();
+extern void CAN2_TX_irq_handler();
 extern void CAN2_FIFO0_irq_handler();
 extern void CAN2_FIFO1_irq_handler();
 extern void USART1_irq_handler();
+extern void fw_work_irq_handler();
+extern void fw_clock_irq_handler();
 extern void USART2_irq_handler();
 extern void ADC1_irq_ovr_handler();
 extern void TIM2_irq_handler();
@@ -52,7 +56,7 @@ extern void TIM5_irq_handler();
 #define DMA1_Stream5_IRQHandler DefaultISR
 #define DMA1_Stream6_IRQHandler DefaultISR
 #define ADC_IRQHandler ADC1_irq_ovr_handler
-#define CAN1_TX_IRQHandler DefaultISR
+#define CAN1_TX_IRQHandler CAN1_TX_irq_handler
 #define CAN1_RX0_IRQHandler CAN1_FIFO0_irq_handler
 #define CAN1_RX1_IRQHandler CAN1_FIFO1_irq_handler
 #define CAN1_SCE_IRQHandler DefaultISR
@@ -88,7 +92,7 @@ extern void TIM5_irq_handler();
 #define UART4_IRQHandler DefaultISR
 #define UART5_IRQHandler DefaultISR
 #define TIM6_DAC_IRQHandler DefaultISR
-#define TIM7_IRQHandler DefaultISR
+#define TIM7_IRQHandler fw_clock_irq_handler
 #define DMA2_Stream0_IRQHandler DefaultISR
 #define DMA2_Stream1_IRQHandler DefaultISR
 #define DMA2_Stream2_IRQHandler DefaultISR
@@ -96,7 +100,7 @@ extern void TIM5_irq_handler();
 #define DMA2_Stream4_IRQHandler DefaultISR
 #define ETH_IRQHandler DefaultISR
 #define ETH_WKUP_IRQHandler DefaultISR
-#define CAN2_TX_IRQHandler DefaultISR
+#define CAN2_TX_IRQHandler CAN2_TX_irq_handler
 #define CAN2_RX0_IRQHandler CAN2_FIFO0_irq_handler
 #define CAN2_RX1_IRQHandler CAN2_FIFO1_irq_handler
 #define CAN2_SCE_IRQHandler DefaultISR
@@ -112,7 +116,7 @@ extern void TIM5_irq_handler();
 #define OTG_HS_WKUP_IRQHandler DefaultISR
 #define OTG_HS_IRQHandler DefaultISR
 #define DCMI_IRQHandler DefaultISR
-#define HASH_RNG_IRQHandler DefaultISR
+#define HASH_RNG_IRQHandler fw_work_irq_handler
 #define FPU_IRQHandler DefaultISR
 
 #if defined(__cplusplus)
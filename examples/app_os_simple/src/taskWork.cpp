@@ -14,26 +14,12 @@
  *  limitations under the License.
  */
 
-#pragma once
-
-#include <inttypes.h>
-#include <fwapi.h>
-
-typedef struct FwFifo {
-    char *arr;
-    int wcnt;
-    int rcnt;
-    int size;
-} FwFifo;
-
-void fw_fifo_init(FwFifo *ff, int sz);
-
-int fw_fifo_get_count(FwFifo *ff);
-
-int fw_fifo_is_empty(FwFifo *ff);
-
-int fw_fifo_is_full(FwFifo *ff);
-
-void fw_fifo_put(FwFifo *ff, char v);
-
-void fw_fifo_get(FwFifo *ff, char *v);
+#include <prjtypes.h>
+#include <fwwork.h>
+#include "app_tasks.h"
+
+portTASK_FUNCTION(taskWork, args)
+{
+    // Execute work items posted by interrupt handlers
+    fw_work_run(FW_WORK_HIGH);
+}
@@ -37,6 +37,10 @@ ManagementClass::ManagementClass(TaskHandle_t taskHandle)
     errCnt_[CAN1] = 0;
     errCnt_[CAN2] = 0;
     history_total_prev_ = 0;
+    for (int i = 0; i < CAN_Total; i++) {
+        lastid_[i] = 0;
+        rxseen_[i] = false;
+    }
     last_errcode_ = ~0ul;
     estate_ = State_SplashScreen;
 }
@@ -45,6 +49,19 @@ void ManagementClass::Init() {
 }
 
 void ManagementClass::PostInit() {
+    // Bind attributes before key listener could use them
+    for (int i = 0; i < CAN_Total; i++) {
+        can_[i].rxcnt.bind(CAN_NAMES[i], "rxcnt");
+        can_[i].mode.bind(CAN_NAMES[i], "mode");
+        can_[i].pgm.bind(CAN_NAMES[i], "pgm");
+        can_[i].errcnt.bind(CAN_NAMES[i], "errcnt");
+        can_[i].lasterr.bind(CAN_NAMES[i], "lasterr");
+    }
+    injCan1Util_.bind("inj0", "can1_util");
+    injCnt_.bind("inj0", "cnt");
+    injInject_.bind("inj0", "inject");
+    rtcTime_.bind("rtc", "Time");
+
     KeyInterface *iface = reinterpret_cast<KeyInterface *>(
             fw_get_object_interface("ubtn0", "KeyInterface"));
     if (iface) {
@@ -54,6 +71,23 @@ void ManagementClass::PostInit() {
 
     disp0_ = reinterpret_cast<DisplayInterface *>(
         fw_get_object_interface("disp0", "DisplayInterface"));
+
+    // Bus monitor needs all frames, this also keeps acceptance filters open
+    for (int i = 0; i < CAN_Total; i++) {
+        CanInterface *ican = reinterpret_cast<CanInterface *>(
+            fw_get_object_interface(CAN_NAMES[i], "CanInterface"));
+        if (ican) {
+            ican->RegisterCanListener(static_cast<CanListenerInterface *>(this));
+        }
+    }
+}
+
+void ManagementClass::CanCallback(can_frame_type *frame) {
+    if (frame->busid >= CAN_Total) {
+        return;
+    }
+    lastid_[frame->busid] = frame->id;
+    rxseen_[frame->busid] = true;
 }
 
 
@@ -83,7 +117,7 @@ void ManagementClass::update() {
         drawPgmValue(0, CAN1);
         drawCan1ListenerMode();
         drawErrorCodeLine(4, CAN1);
-        if (read_uint32("can1", "mode") == 3) {
+        if (can_[CAN1].mode.read() == 3) {
             disp0_->clearLines(150, 90, RGB16_GRAY_BKG);
             disp0_->clearLines(151, 1, RGB16_WHITE);
             estate_ = State_CanInjector;
@@ -101,7 +135,7 @@ void ManagementClass::update() {
         drawCan1ListenerMode();
         drawErrorCodeLine(4, CAN1);
         drawDebugLog();
-        if (read_uint32("can1", "mode") == 3) {
+        if (can_[CAN1].mode.read() == 3) {
             estate_ = State_CanInjector;
         } else if (history_total_prev_ != msg_history_.total) {
             updateCnt_ = 0;
@@ -119,7 +153,7 @@ void ManagementClass::update() {
         drawCan1InjectorMode();
         drawErrorCodeLine(4, CAN1);
         drawDebugLog();
-        if (read_uint32("can1", "mode") != 3) {
+        if (can_[CAN1].mode.read() != 3) {
             estate_ = State_CanListenerWithLog;
             updateCnt_ = 0;
         }
@@ -133,9 +167,9 @@ void ManagementClass::drawCan1ListenerMode() {
     uint32_t t1, t2;
     char tstr[20];
 
-    t2 = static_cast<uint32_t>(100.0f*read_float32("inj0", "can1_util") + 0.5f); // 2 points precision
+    t2 = static_cast<uint32_t>(100.0f*injCan1Util_.read() + 0.5f); // 2 points precision
 
-    t1 = read_uint32("can1", "rxcnt");
+    t1 = can_[CAN1].rxcnt.read();
     snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "%d.%02d/%d    ",
                 t2/100, t2%100, t1);
     tstr[12] = 0;
@@ -143,11 +177,11 @@ void ManagementClass::drawCan1ListenerMode() {
 
     drawErrorCntValue(2, CAN1);
 
-    t1 = read_uint32("can1", "mode");
+    t1 = can_[CAN1].mode.read();
     if (t1 == 0) {
         disp0_->outputText24Line("Bus OFF           ", 3, 1, 0xF7E7, 0x0000);
     } else if (t1 == 2) {
-        disp0_->outputText24Line("Bus Listener      ", 3, 1, 0x47EB, 0x0000);
+        drawBusState(3, CAN1);
     } else if (t1 == 3) {
         disp0_->outputText24Line("Bus Injector      ", 3, 1, 0x47EB, 0x0000);
     } else {
@@ -159,8 +193,8 @@ void ManagementClass::drawCan1InjectorMode() {
     uint32_t t1, t2;
     char tstr[20];
 
-    t2 = static_cast<uint32_t>(100.0f*read_float32("inj0", "can1_util") + 0.5f); // 2 points precision
-    t1 = read_uint32("can1", "rxcnt");
+    t2 = static_cast<uint32_t>(100.0f*injCan1Util_.read() + 0.5f); // 2 points precision
+    t1 = can_[CAN1].rxcnt.read();
     snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "%d.%02d/%d    ",
                 t2/100, t2%100, t1);
     tstr[12] = 0;
@@ -168,7 +202,7 @@ void ManagementClass::drawCan1InjectorMode() {
 
     drawErrorCntValue(2, CAN1);
 
-    t1 = read_uint32("inj0", "cnt");
+    t1 = injCnt_.read();
     snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "%d         ", t1);
     disp0_->outputText24Line("Inj98/1 ", 3, 1, 0xFBBB, 0x0000);
     disp0_->outputText24Line(tstr, 3, 9, 0xFBBB, 0xAC00);
@@ -179,17 +213,17 @@ void ManagementClass::drawCan2ListenerMode() {
     uint32_t t1;
     char tstr[20];
 
-    t1 = read_uint32("can2", "rxcnt");
+    t1 = can_[CAN2].rxcnt.read();
     snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "%d      ", t1);
     disp0_->outputText24Line(tstr, 5, 9, 0xffff, 0x0000);
 
     drawErrorCntValue(6, CAN2);
 
-    t1 = read_uint32("can2", "mode");
+    t1 = can_[CAN2].mode.read();
     if (t1 == 0) {
         disp0_->outputText24Line("Bus OFF           ", 7, 1, 0xF7E7, 0x0000);
     } else if (t1 == 2) {
-        disp0_->outputText24Line("Bus Listener      ", 7, 1, 0x47EB, 0x0000);
+        drawBusState(7, CAN2);
     } else {
         disp0_->outputText24Line("No Data           ", 7, 1, 0x6B6D, 0x0000);
     }
@@ -212,16 +246,29 @@ void ManagementClass::drawDebugLog() {
     history_total_prev_ = msg_history_.total;
 }
 
+void ManagementClass::drawBusState(int lineidx, int canidx) {
+    char tstr[20];
+    if (!rxseen_[canidx]) {
+        disp0_->outputText24Line("Bus Listener      ", lineidx, 1, 0x47EB, 0x0000);
+        return;
+    }
+    rxseen_[canidx] = false;
+    snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "Rx ID %08x      ",
+                lastid_[canidx]);
+    tstr[18] = 0;
+    disp0_->outputText24Line(tstr, lineidx, 1, 0x47EB, 0x0000);
+}
+
 void ManagementClass::drawPgmValue(int lineidx, int canidx) {
     char tstr[20];
     snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "%d  ",
-                read_int8(CAN_NAMES[canidx], "pgm"));
+                can_[canidx].pgm.read());
     disp0_->outputText24Line(tstr, lineidx, 9, 0xFFFF, 0x61d0);
 }
 
 void ManagementClass::drawErrorCntValue(int lineidx, int canidx) {
     char tstr[20];
-    uint32_t t1 = read_uint32(CAN_NAMES[canidx], "errcnt");
+    uint32_t t1 = can_[canidx].errcnt.read();
     snprintf_lib(tstr, static_cast<int>(sizeof(tstr)), "%d          ", t1);
     tstr[12] = 0;
     if (t1 != errCnt_[canidx]) {
@@ -234,7 +281,7 @@ void ManagementClass::drawErrorCntValue(int lineidx, int canidx) {
 
 void ManagementClass::drawErrorCodeLine(int lineidx, int canidx) {
     // Show Last injected error code
-    uint32_t t1 = read_uint32(CAN_NAMES[canidx], "lasterr");
+    uint32_t t1 = can_[canidx].lasterr.read();
     if (last_errcode_ == t1) {
         return;
     }
@@ -273,13 +320,13 @@ void ManagementClass::keyPressed() {
                 eNoAction);
     btnClick_ = true;
 
-    uint32_t canmod = read_uint32("can1", "mode");
+    uint32_t canmod = can_[CAN1].mode.read();
     if (canmod == 2) {
-        write_uint32("can1", "mode", 3);
-        write_uint32("inj0", "inject", 1);
+        can_[CAN1].mode.write(3);
+        injInject_.write(1);
     } else if (canmod == 3) {
-        write_uint32("can1", "mode", 2);
-        write_uint32("inj0", "inject", 0);
+        can_[CAN1].mode.write(2);
+        injInject_.write(0);
     }
 
 }
@@ -296,77 +343,6 @@ void ManagementClass::waitKeyPressed() {
                     portMAX_DELAY); // Block indefinetly
 }
 
-void ManagementClass::write_obj_attribute(const char *objname,
-                         const char *atrname,
-                         char *buf,
-                         int sz) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        atr->write(buf, sz, false);
-    } else {
-        uart_printf("[%d] %s:%s not found\r\n",
-            xTaskGetTickCount(), objname, atrname);
-    }
-}
-
-void ManagementClass::write_int8(const char *objname,
-                                const char *atrname,
-                                int8_t v) {
-    char buf[2] = {static_cast<char>(v), 0};
-    write_obj_attribute(objname, atrname, buf, 1);
-}
-
-void ManagementClass::write_uint32(const char *objname,
-                                   const char *atrname,
-                                   uint32_t v) {
-    char buf[5] = {static_cast<char>(v),
-                   static_cast<char>(v >> 8),
-                   static_cast<char>(v >> 16),
-                   static_cast<char>(v >> 24)};
-    write_obj_attribute(objname, atrname, buf, 4);
-}
-
-int8_t ManagementClass::read_int8(const char *objname,
-                                   const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_int8();
-    }
-    return 0;
-}
-
-uint16_t ManagementClass::read_uint16(const char *objname,
-                                      const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_uint16();
-    }
-    return 0;
-}
-
-uint32_t ManagementClass::read_uint32(const char *objname,
-                                      const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_uint32();
-    }
-    return 0;
-}
-
-float ManagementClass::read_float32(const char *objname,
-                                    const char *atrname) {
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute(objname, atrname));
-    if (atr) {
-        return atr->to_float();
-    }
-    return 0;
-}
-
 uint32_t ManagementClass::getTimeOfDay() {
     uint32_t tow = 0;
     // [31:23] reserved
@@ -379,7 +355,7 @@ uint32_t ManagementClass::getTimeOfDay() {
     // [7] resered
     // [6:4] Seconds tens in BCD format
     // [3:0] Seconds units in BCD format
-    uint32_t rtc_time = read_uint32("rtc", "Time");
+    uint32_t rtc_time = rtcTime_.read();
     tow = ((rtc_time >> 20) & 0x3) * 10 * 3600; // seconds
     tow += ((rtc_time >> 16) & 0xF) * 3600;
     tow += ((rtc_time >> 12) & 0x7) * 10 * 60;
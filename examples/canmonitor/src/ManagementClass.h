@@ -17,8 +17,10 @@
 #include <prjtypes.h>
 #include <fwobject.h>
 #include <fwattribute.h>
+#include <fwattrref.h>
 #include <KeyInterface.h>
 #include <DisplayInterface.h>
+#include <CanInterface.h>
 #include <task.h>
 
 enum CanNames {
@@ -28,7 +30,8 @@ enum CanNames {
 };
 
 class ManagementClass : public FwObject,
-                        public KeyListenerInterface {
+                        public KeyListenerInterface,
+                        public CanListenerInterface {
  public:
     ManagementClass(TaskHandle_t taskHandle);
 
@@ -43,6 +46,9 @@ class ManagementClass : public FwObject,
     virtual void keyDoubleClick() override {}
     virtual void keyLongClick() override {}
 
+    // CanListenerInterface: monitor subscribes on all frames of both buses
+    virtual void CanCallback(can_frame_type *frame) override;
+
  public:
     void update();
 
@@ -54,28 +60,10 @@ class ManagementClass : public FwObject,
     void drawPgmValue(int lineidx, int canidx);
     void drawErrorCntValue(int lineidx, int canidx);
     void drawErrorCodeLine(int lineidx, int canidx);
+    void drawBusState(int lineidx, int canidx);
 
  protected:
     void waitKeyPressed();
-    void write_obj_attribute(const char *objname,
-                             const char *atrname,
-                             char *buf,
-                             int sz);
-    void write_int8(const char *objname,
-                    const char *atrname,
-                    int8_t v);
-    void write_uint32(const char *objname,
-                      const char *atrname,
-                      uint32_t v);
-    int8_t read_int8(const char *objname,
-                     const char *atrname);
-    uint16_t read_uint16(const char *objname,
-                        const char *atrname);
-    uint32_t read_uint32(const char *objname,
-                         const char *atrname);
-    float read_float32(const char *objname,
-                         const char *atrname);
-
     uint32_t getTimeOfDay();
 
  private:
@@ -92,5 +80,20 @@ class ManagementClass : public FwObject,
         State_CanInjector
     } estate_;
     int history_total_prev_;
+    volatile uint32_t lastid_[CAN_Total];   // last received CAN ID
+    volatile bool rxseen_[CAN_Total];       // frame received since update
     uint32_t last_errcode_;
+
+    // Attributes of other objects bound in PostInit()
+    struct CanRefs {
+        FwAttrRef<uint32_t> rxcnt;
+        FwAttrRef<uint32_t> mode;
+        FwAttrRef<int8_t> pgm;
+        FwAttrRef<uint32_t> errcnt;
+        FwAttrRef<uint32_t> lasterr;
+    } can_[CAN_Total];
+    FwAttrRef<float> injCan1Util_;
+    FwAttrRef<uint32_t> injCnt_;
+    FwAttrRef<uint32_t> injInject_;
+    FwAttrRef<uint32_t> rtcTime_;
 };
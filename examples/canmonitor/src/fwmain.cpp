@@ -44,8 +44,9 @@ void show_int(int val, int line, int col) {
 #endif
 
 extern "C" int fwmain(int argcnt, char *args[]) {
-    TaskHandle_t handleTask1ms;
+    TaskHandle_t handleTask1ms[FW_EXEC_CLASSES_TOTAL];
     TaskHandle_t handleTaskEpoch;
+    TaskHandle_t handleTaskWork;
 
     fw_init();
     show_int(15, 3, 12);
@@ -54,15 +55,27 @@ extern "C" int fwmain(int argcnt, char *args[]) {
 
     uart_printf("%s\n", "Starting FreeRTOS scheduler!\r\n");
 
-    xTaskCreate(task1ms,
-                 APP_TASK_NAME,
+    // Deferred interrupt processing preempts all other tasks
+    xTaskCreate(taskWork,
+                 APP_WORK_TASK_NAME,
                  512,
                  NULL,
-                 tskIDLE_PRIORITY + 2UL,
-                 &handleTask1ms);
+                 tskIDLE_PRIORITY + 6UL,
+                 &handleTaskWork);
+
+    // Timer service task per execution class: realtime class gets
+    // the highest priority, background is just above the epoch task.
+    for (int i = 0; i < FW_EXEC_CLASSES_TOTAL; i++) {
+        xTaskCreate(task1ms,
+                     APP_EXEC_TASK_NAME[i],
+                     512,
+                     reinterpret_cast<void *>(static_cast<intptr_t>(i)),
+                     tskIDLE_PRIORITY + 5UL - i,
+                     &handleTask1ms[i]);
+    }
 
     xTaskCreate(taskEpoch,
-                 APP_TASK_NAME,
+                 APP_EPOCH_TASK_NAME,
                  1024,
                  NULL,
                  tskIDLE_PRIORITY + 1UL,
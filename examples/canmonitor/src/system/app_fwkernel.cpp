@@ -20,25 +20,36 @@
 #include <string.h>
 #include <new>
 
+#define APP_OBJECT_ENTRY(type, member, name, ...) \
+    FW_STATIC_ENTRY(AppKernelClass, member, name),
+
+FW_STATIC_TABLE_BEGIN
+const FwStaticEntry AppKernelClass::OBJECTS[] = {
+    {FW_HASH("kernel"), 0},
+    KERNEL_GENERIC_OBJECTS(APP_OBJECT_ENTRY)
+    APP_KERNEL_OBJECTS(APP_OBJECT_ENTRY)
+};
+FW_STATIC_TABLE_END
+
+const int AppKernelClass::OBJECTS_TOTAL = FW_STATIC_TABLE_SIZE(OBJECTS);
+
 /**
  * @brief Kernel module constructor. Instance of this KernelClass registered
  *        as the first element in the single linked list of FwObjects.
  */
-AppKernelClass::AppKernelClass(const char *name) : KernelClassGeneric(name),
-    uart1_("uart1"),
-    rtc_("rtc"),
-    can1_("can1", 0),
-    can2_("can2", 1),
-    injector0_("inj0"),
-    uled0_("uled0"),
-    ubtn0_("ubtn0"),
-    disp0_("disp0")
+AppKernelClass::AppKernelClass(const char *name) : KernelClassGeneric(name)
+    APP_KERNEL_OBJECTS(FW_STATIC_INIT)
 {
     version_.make_uint32(0x20250812);
     output_.make_int32(0);
 }
 
 extern "C" void kernel_init() {
-    new (fw_malloc(sizeof(AppKernelClass))) AppKernelClass("kernel");
+    void *kernel = fw_malloc(sizeof(AppKernelClass));
+    fw_register_static_objects(kernel,
+                               sizeof(AppKernelClass),
+                               AppKernelClass::OBJECTS,
+                               AppKernelClass::OBJECTS_TOTAL);
+    new (kernel) AppKernelClass("kernel");
 }
 
@@ -22,6 +22,32 @@
 #include "user_led.h"
 #include "user_btn.h"
 #include <display_spi_f4xx.h>
+#include "memstat.h"
+#include "pwrstat.h"
+#include "profiler.h"
+#include "tracer.h"
+
+/** CAN receive ring depth per bus: frames buffered until a task drains them */
+#define APP_CAN_RX_FRAMES 128
+
+/**
+ * @brief Kernel objects in DBC index order after the generic ones. Items
+ *        X(type, member, name, ...) are expanded into the members, their
+ *        constructor calls and the static table (see FW_STATIC_MEMBER).
+ */
+#define APP_KERNEL_OBJECTS(X) \
+    X(UartDriver, uart1_, "uart1") \
+    X(RtcDriver, rtc_, "rtc") \
+    X(CanDriver, can1_, "can1", 0, APP_CAN_RX_FRAMES) \
+    X(CanDriver, can2_, "can2", 1, APP_CAN_RX_FRAMES) \
+    X(CanInjectorDriver, injector0_, "inj0") \
+    X(UserLedDriver, uled0_, "uled0") \
+    X(UserButtonDriver, ubtn0_, "ubtn0") \
+    X(DisplaySPI_F4xx, disp0_, "disp0") \
+    X(MemoryStatDriver, mem_, "mem") \
+    X(PowerStatDriver, pwr_, "pwr") \
+    X(ProfilerDriver, prof_, "prof") \
+    X(TraceDriver, trace_, "trace")
 
 class AppKernelClass : public KernelClassGeneric {
  public:
@@ -30,14 +56,10 @@ class AppKernelClass : public KernelClassGeneric {
     // FwObject interface:
     //virtual void PostInit() override;
 
+    /** @brief Flash resident table of the kernel objects in DBC index order */
+    static const FwStaticEntry OBJECTS[];
+    static const int OBJECTS_TOTAL;
+
  private:
-    /** @brief Kernel Version attribute */
-    UartDriver uart1_;
-    RtcDriver rtc_;
-    CanDriver can1_;
-    CanDriver can2_;
-    CanInjectorDriver injector0_;
-    UserLedDriver uled0_;
-    UserButtonDriver ubtn0_;
-    DisplaySPI_F4xx disp0_;
+    APP_KERNEL_OBJECTS(FW_STATIC_MEMBER)
 };
@@ -19,25 +19,22 @@
 #include <prjtypes.h>
 #include <stm32f4xx_map.h>
 #include <fwapi.h>
+#include <fwirq.h>
 #include <uart.h>
 #include <spi.h>
 #include <display_spi.h>
 
-extern IrqHandlerInterface *drv_display_spi_tx_;
-extern IrqHandlerInterface *drv_can_injector_exti_;         // can1 sof
-extern IrqHandlerInterface *drv_can_injector_tim_;          // inject error bits
-
 extern "C" void CanMonitor_SPI3_irq_handler() {
-    /*SPI_registers_type *SPI3 = (SPI_registers_type *)SPI3_BASE;
-    if (drv_display_spi_tx_) {
-        drv_display_spi_tx_->handleInterrupt(0);
-    }*/
+    /*fw_irq_dispatch(51, 0);*/
 }
 
 extern "C" void CanMonitor_TIM4_irq_handler() {
     TIM_registers_type *TIM4 = (TIM_registers_type *)TIM4_BASE;
-    if (drv_can_injector_tim_) {
-        drv_can_injector_tim_->handleInterrupt(0);
+    // [0] UIF update interrupt flag
+    if ((read16(&TIM4->SR) & 0x1) == 0) {
+        fw_irq_spurious(30);
+    } else {
+        fw_irq_dispatch(30, 0);
     }
 
     write16(&TIM4->SR, 0);  // clear all pending bits
@@ -46,8 +43,11 @@ extern "C" void CanMonitor_TIM4_irq_handler() {
 
 // Irq[9] EXTI3 (connectected to CAN1 Rx)
 extern "C" void EXTI3_CanSofListener_IRQHandler() {
-    if (drv_can_injector_exti_) {
-        drv_can_injector_exti_->handleInterrupt(0);
+    EXTI_registers_type *EXTI = (EXTI_registers_type *)EXTI_BASE;
+    if ((read32(&EXTI->PR) & (1 << 3)) == 0) {
+        fw_irq_spurious(9);
+    } else {
+        fw_irq_dispatch(9, 0);
     }
     nvic_irq_disable(9);    // disable EXTI, must be re-enabled by CAN end-of-frame
 }
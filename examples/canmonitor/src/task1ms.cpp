@@ -20,52 +20,51 @@
 #include <uart.h>
 #include <fwapi.h>
 #include <fwobject.h>
-#include <TimerInterface.h>
+#include <fwtimer.h>
 #include "app_tasks.h"
 
-struct TimerCallbackType : public FwList {
+static TimerListenerInterface *get_timer_listener(int idx, int cls) {
+    FwObject *obj = reinterpret_cast<FwObject *>(fw_get_obj_by_index(idx));
+    CommonInterface *iface = obj->GetInterface("TimerListenerInterface");
     TimerListenerInterface *listener;
-    uint64_t tm;
-};
-
+    if (iface == 0) {
+        return 0;
+    }
+    listener = static_cast<TimerListenerInterface *>(iface);
+    if (listener->getExecClass() != cls) {
+        return 0;
+    }
+    return listener;
+}
 
+/**
+ * @brief Timer service task of one execution class, class index (EFwExecClass)
+ *        is passed as argument. It serves only listeners of this class.
+ */
 portTASK_FUNCTION(task1ms, args)
 {
-    FwList *p = fw_get_objects_list();
-    FwObject *obj;
-    CommonInterface *iface;
-    TimerCallbackType *item;
-    FwList *listener = 0;
-    uint64_t tickcnt = 0;
-
-
-    while (p) {
-        obj = static_cast<FwObject *>(fwlist_get_payload(p));
-        iface = obj->GetInterface("TimerListenerInterface");
-        if (iface) {
-            item = reinterpret_cast<TimerCallbackType *>(
-                    fw_malloc(sizeof(TimerCallbackType)));
+    int cls = static_cast<int>(reinterpret_cast<intptr_t>(args));
+    TimerListenerInterface *listener;
+    FwTimer *t;
+    int total = 0;
 
-            item->listener =
-                static_cast<TimerListenerInterface *>(iface);
-            item->tm = item->listener->getTimerInterval();
-            fwlist_add(&listener, item);
+    for (int i = 0; i < fw_get_objects_count(); i++) {
+        if (get_timer_listener(i, cls)) {
+            total++;
         }
-        p = p->next;
     }
 
-    while (1) {
-        tickcnt++;
-        item = static_cast<TimerCallbackType *>(listener);
-        while (item) {
-            if (tickcnt >= item->tm) {
-                item->listener->callbackTimer(tickcnt);
-                item->tm = tickcnt + item->listener->getTimerInterval();
-            }
-            item = static_cast<TimerCallbackType *>(item->next);
-        }
+    // Extra slots for one-shot timers created in run-time
+    fw_timer_init(cls, total + APP_TIMERS_ONESHOT_MAX);
 
-        vTaskDelay(pdMS_TO_TICKS(1));
+    for (int i = 0; i < fw_get_objects_count(); i++) {
+        listener = get_timer_listener(i, cls);
+        if (listener) {
+            t = fw_timer_create(listener, 0);
+            fw_timer_start(t, static_cast<uint32_t>(listener->getTimerInterval()));
+        }
     }
-}
 
+    // Sleep until the nearest deadline instead of 1 ms polling
+    fw_timer_run(cls);
+}
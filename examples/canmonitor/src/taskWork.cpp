@@ -0,0 +1,25 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <fwwork.h>
+#include "app_tasks.h"
+
+portTASK_FUNCTION(taskWork, args)
+{
+    // Execute work items posted by interrupt handlers
+    fw_work_run(FW_WORK_HIGH);
+}
@@ -30,6 +30,7 @@ class AdcChannel : public FwAttribute,
     AdcChannel(FwObject *parent, const char *name, int idx, const char *descr);
 
     // FwAttribute
+    virtual bool isPackable() override { return false; }
     virtual void pre_read() override ;
     virtual float getMaxValue() override { return 3.3f; }
     virtual float getScaleRateValue() override { return 10000.0f; }
@@ -17,7 +17,12 @@
 #include <prjtypes.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwirq.h>
+#include <fwwork.h>
+#include <fwclock.h>
+#include <fwwait.h>
 #include <uart.h>
+#include <string.h>
 #include "can_drv.h"
 
 /** Instead of using interface, use this gloval var. Bad, but is is faster.
@@ -29,117 +34,128 @@ can_msg_history_type msg_history_;
 extern "C" void CAN1_EndOfFrame();
 extern "C" void CAN2_EndOfFrame();
 
-extern "C" void CAN1_FIFO0_irq_handler() {
-    CAN1_EndOfFrame();
+/** Init request is acknowledged after the current frame on the bus ends */
+#define CAN_INIT_TIMEOUT_US 10000
+
+static int can_tx_empty(void *arg) {
+    CAN_registers_type *dev = reinterpret_cast<CAN_registers_type *>(arg);
+    // [28:26] TME2..TME0: all mailboxes are empty
+    return (read32(&dev->TSR.val) & (0x7ul << 26)) == (0x7ul << 26);
+}
+
+static int can_init_ack(void *arg) {
+    CAN_registers_type *dev = reinterpret_cast<CAN_registers_type *>(arg);
+    CAN_MSR_type msr;
+    msr.val = read32(&dev->MSR.val);
+    return msr.b.INAK == 1 && msr.b.SLAK == 0;
+}
+
+static uint32_t can_id_hash(uint32_t id) {
+    // Standard identifier is in bits [28:18] of the frame id
+    return id ^ (id >> 18);
+}
 
-    IrqHandlerInterface *iface = reinterpret_cast<IrqHandlerInterface *>(
-            fw_get_object_interface("can1", "IrqHandlerInterface"));
-    if (iface) {
-        int fifoid = 0;
-        iface->handleInterrupt(&fifoid);
+enum EFilterKind {
+    FILTER_STD_ID,      // exact standard ID: 16-bit list, 4 per bank
+    FILTER_EXT_ID,      // exact extended ID: 32-bit list, 2 per bank
+    FILTER_MASK         // 32-bit mask, 1 per bank
+};
+
+static int can_filter_kind(uint32_t fr, uint32_t mask) {
+    if (mask != 0xFFFFFFFE) {
+        return FILTER_MASK;
     }
-    nvic_irq_clear(20);
+    // [2] IDE
+    return (fr & 0x4) ? FILTER_EXT_ID : FILTER_STD_ID;
 }
 
-extern "C" void CAN1_FIFO1_irq_handler() {
-    CAN1_EndOfFrame();
+static int can_filter_banks(int stdcnt, int extcnt, int maskcnt) {
+    return (stdcnt + 3) / 4 + (extcnt + 1) / 2 + maskcnt;
+}
 
-    IrqHandlerInterface *iface = reinterpret_cast<IrqHandlerInterface *>(
-            fw_get_object_interface("can1", "IrqHandlerInterface"));
-    if (iface) {
-        int fifoid = 1;
-        iface->handleInterrupt(&fifoid);
+static int can_bits_count(uint32_t v) {
+    int ret = 0;
+    while (v) {
+        v &= v - 1;
+        ret++;
     }
-    nvic_irq_clear(21);
+    return ret;
 }
 
-extern "C" void CAN1_SCE_irq_handler() {
-    CAN_registers_type *dev = (CAN_registers_type *)CAN1_BASE;
-    CAN_ESR_type esr;
-    char errmsg[5] = "e0\r\n";
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute("can1", "errcnt"));
-    // [6:4] LEC. Last Error Code
-    //      000 No error
-    //      001 Stuff error
-    //      010 Form error
-    //      011 Ack error
-    //      100 Bit recessive error
-    //      101 Bit dominant error
-    //      110 CRC error
-    //      111 Set by software
-    // [2] BOFF. Bus off flag
-    // [1] EPVF. Error passive flag
-    // [0] EWGF. Error warning flag
-    if (atr) {
-        atr->make_uint32(atr->to_uint32() + 1);
+static void can_rx_irq(CAN_registers_type *dev, int irqidx, int fifoid) {
+    // [1:0] FMP. Number of messages pending in the FIFO
+    if ((read32(&dev->RF[fifoid].val) & 0x3) == 0) {
+        fw_irq_spurious(irqidx);
     } else {
-        uart_printk("err %d\r\n", __LINE__);
+        fw_irq_dispatch(irqidx, &fifoid);
     }
-    esr.val = read32(&dev->ESR.val);
-    errmsg[1] += static_cast<char>(esr.b.LEC);
+    nvic_irq_clear(irqidx);
+}
+
+static void can_sce_irq(CAN_registers_type *dev, int irqidx) {
+    int argv = CanDriver::IRQ_SCE;
+    CAN_MSR_type msr;
 
-    atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute("can1", "lasterr"));
-    if (atr) {
-        atr->make_uint32(esr.val);
+    msr.val = read32(&dev->MSR.val);
+    if (msr.b.ERRI == 0) {
+        fw_irq_spurious(irqidx);
     } else {
-        uart_printk("err %d\r\n", __LINE__);
+        fw_irq_dispatch(irqidx, &argv);
     }
-    /*uart_printk(errmsg);
+    // [2] ERRI error interrupt.
+    write32(&dev->MSR.val, 1 << 2);
+    nvic_irq_clear(irqidx);
+}
 
-    if (esr.b.BOFF) {
-        uart_printk("err BOFF\r\n");
-    }
-    if (esr.b.EPVF) {
-        uart_printk("err EPVF\r\n");
+static void can_tx_irq(CAN_registers_type *dev, int irqidx) {
+    int argv = CanDriver::IRQ_TX;
+    // [16] RQCP2, [8] RQCP1, [0] RQCP0: request completed
+    if ((read32(&dev->TSR.val) & 0x10101) == 0) {
+        fw_irq_spurious(irqidx);
+    } else {
+        fw_irq_dispatch(irqidx, &argv);
     }
-    if (esr.b.EWGF) {
-        uart_printk("err EWGF\r\n");
-    }*/
+    nvic_irq_clear(irqidx);
+}
 
-    // [2] ERRI error interrupt.
-    write32(&dev->MSR.val, 1 << 2);
-    nvic_irq_clear(22);
+extern "C" void CAN1_TX_irq_handler() {
+    can_tx_irq((CAN_registers_type *)CAN1_BASE, 19);
+}
+
+extern "C" void CAN2_TX_irq_handler() {
+    can_tx_irq((CAN_registers_type *)CAN2_BASE, 63);
+}
+
+extern "C" void CAN1_FIFO0_irq_handler() {
+    CAN1_EndOfFrame();
+    can_rx_irq((CAN_registers_type *)CAN1_BASE, 20, CanDriver::IRQ_FIFO0);
+}
+
+extern "C" void CAN1_FIFO1_irq_handler() {
+    CAN1_EndOfFrame();
+    can_rx_irq((CAN_registers_type *)CAN1_BASE, 21, CanDriver::IRQ_FIFO1);
+}
+
+extern "C" void CAN1_SCE_irq_handler() {
+    can_sce_irq((CAN_registers_type *)CAN1_BASE, 22);
 }
 
 extern "C" void CAN2_FIFO0_irq_handler() {
     CAN2_EndOfFrame();
-    IrqHandlerInterface *iface = reinterpret_cast<IrqHandlerInterface *>(
-            fw_get_object_interface("can2", "IrqHandlerInterface"));
-    if (iface) {
-        int fifoid = 0;
-        iface->handleInterrupt(&fifoid);
-    }
-    nvic_irq_clear(64);
+    can_rx_irq((CAN_registers_type *)CAN2_BASE, 64, CanDriver::IRQ_FIFO0);
 }
 
 extern "C" void CAN2_FIFO1_irq_handler() {
     CAN2_EndOfFrame();
-    IrqHandlerInterface *iface = reinterpret_cast<IrqHandlerInterface *>(
-            fw_get_object_interface("can2", "IrqHandlerInterface"));
-    if (iface) {
-        int fifoid = 1;
-        iface->handleInterrupt(&fifoid);
-    }
-    nvic_irq_clear(65);
+    can_rx_irq((CAN_registers_type *)CAN2_BASE, 65, CanDriver::IRQ_FIFO1);
 }
+
 extern "C" void CAN2_SCE_irq_handler() {
-    CAN_registers_type *dev = (CAN_registers_type *)CAN2_BASE;
-    FwAttribute *atr = reinterpret_cast<FwAttribute *>(
-                fw_get_object_attribute("can2", "errcnt"));
-    if (atr) {
-        atr->make_uint32(atr->to_uint32() + 1);
-    } else {
-        uart_printk("err %d\r\n", __LINE__);
-    }
-    // [2] ERRI error interrupt.
-    write32(&dev->MSR.val, 1 << 2);
-    nvic_irq_clear(66);
+    can_sce_irq((CAN_registers_type *)CAN2_BASE, 66);
 }
 
 
-CanDriver::CanDriver(const char *name, int busid) : FwObject(name),
+CanDriver::CanDriver(const char *name, int busid, int rxdepth) : FwObject(name),
     baudrate_("baudrate"),
     mode_("mode"),
     rxcnt_("rxcnt"),
@@ -147,10 +163,37 @@ CanDriver::CanDriver(const char *name, int busid) : FwObject(name),
     errcnt_("errcnt"),
     lasterr_("lasterr"),
     errTrigger_(this, "errTrigger"),
-    busid_(busid) {
-    rxframe_rcnt = 0;
-    rxframe_wcnt = 1;
-    
+    rxdrop_("rxdrop"),
+    rxovr_("rxovr"),
+    rxhwm_("rxhwm"),
+    svcdrop_("svcdrop"),
+    polldrop_("polldrop"),
+    fltutil_("fltutil"),
+    silent_(this, "silent"),
+    txdrop_("txdrop"),
+    txstat_(this, "txstat", "Write CAN ID, read: [15:0] sent, "
+            "[23:16] aborted, [31:24] errors", 0),
+    txts_(this, "txts", "[us] Tx complete time of the txstat ID", &txstat_),
+    busid_(busid),
+    masked_(0),
+    hasListeners_(false),
+    dispatchPending_(false),
+    pollActive_(false),
+    wantedcnt_(0),
+    wantedOverflow_(false),
+    filtersApplied_(false),
+    txcnt_(0),
+    txseq_(0),
+    txhold_(false) {
+    memset(&exact_, 0, sizeof(exact_));
+    memset(txbusy_, 0, sizeof(txbusy_));
+    memset(txabort_, 0, sizeof(txabort_));
+    memset(txids_, 0, sizeof(txids_));
+    memset(&txother_, 0, sizeof(txother_));
+    fw_ring_init(&rxring_, sizeof(can_frame_type), rxdepth);
+    fw_ring_init(&svcring_, sizeof(can_frame_type), CAN_SVC_FRAMES_MAX);
+    fw_ring_init(&pollring_, sizeof(can_frame_type), CAN_POLL_FRAMES_MAX);
+
     for (int i = 0; i < CPU_Total; i++) {
         dbgmsg_[i].buf[2] = ':';
         dbgmsg_[i].buf[3] = 0;
@@ -180,6 +223,14 @@ CanDriver::CanDriver(const char *name, int busid) : FwObject(name),
 
     mode_.make_int8(0);
     pgm_.make_int8(-1);
+    rxdrop_.make_uint32(0);
+    rxovr_.make_uint32(0);
+    rxhwm_.make_uint32(0);
+    svcdrop_.make_uint32(0);
+    polldrop_.make_uint32(0);
+    fltutil_.make_uint32(0);
+    silent_.make_int8(1);
+    txdrop_.make_uint32(0);
 
     RCC_registers_type *RCC = (RCC_registers_type *)RCC_BASE;
     uint32_t t1;
@@ -223,10 +274,12 @@ CanDriver::CanDriver(const char *name, int busid) : FwObject(name),
         nvic_irq_enable(20, 3);   // CAN1_RX0
         nvic_irq_enable(21, 3);   // CAN1_RX1
         nvic_irq_enable(22, 3);   // CAN1_SCE
+        nvic_irq_enable(19, 3);   // CAN1_TX
     } else {
         nvic_irq_enable(64, 3);   // CAN2_RX0
         nvic_irq_enable(65, 3);   // CAN2_RX1
         nvic_irq_enable(66, 3);   // CAN2_SCE
+        nvic_irq_enable(63, 3);   // CAN2_TX
     }
     StartListenerMode();
 }
@@ -242,9 +295,39 @@ void CanDriver::Init() {
     RegisterAttribute(&errcnt_);
     RegisterAttribute(&lasterr_);
     RegisterAttribute(&errTrigger_);
+    RegisterAttribute(&rxdrop_);
+    RegisterAttribute(&rxovr_);
+    RegisterAttribute(&rxhwm_);
+    RegisterAttribute(&svcdrop_);
+    RegisterAttribute(&polldrop_);
+    RegisterAttribute(&fltutil_);
+    RegisterAttribute(&silent_);
+    RegisterAttribute(&txdrop_);
+    RegisterAttribute(&txstat_);
+    RegisterAttribute(&txts_);
+
+    IrqHandlerInterface *iface = static_cast<IrqHandlerInterface *>(this);
+    if (busid_ == 0) {
+        fw_irq_bind(20, iface);     // CAN1_RX0
+        fw_irq_bind(21, iface);     // CAN1_RX1
+        fw_irq_bind(22, iface);     // CAN1_SCE
+        fw_irq_bind(19, iface);     // CAN1_TX
+    } else {
+        fw_irq_bind(64, iface);     // CAN2_RX0
+        fw_irq_bind(65, iface);     // CAN2_RX1
+        fw_irq_bind(66, iface);     // CAN2_SCE
+        fw_irq_bind(63, iface);     // CAN2_TX
+    }
+
+    // PGM state and debug strings are parsed by the driver itself
+    AddAcceptanceFilter(CAN_SVC_PGM_ID, CAN_SVC_PGM_MASK);
+    AddAcceptanceFilter(CAN_SVC_DBG_ID, CAN_SVC_DBG_MASK);
 }
 
 void CanDriver::PostInit() {
+    // Filters added later (other objects PostInit) are applied immediately
+    ApplyAcceptanceFilters();
+    filtersApplied_ = true;
 }
 
 void CanDriver::triggerError() {
@@ -252,19 +335,57 @@ void CanDriver::triggerError() {
     write32(&dev_->ESR.val, 0x7 << 4);
 }
 
+/**
+ * @brief Pending mailboxes are aborted and requeued before the controller
+ *        enters the initialization mode. In the silent mode frames cannot
+ *        be sent, so the queue is dropped into 'txdrop'.
+ */
+void CanDriver::setSilent() {
+    uint32_t primask = DisableIrqSave();
+    txhold_ = true;
+    for (int mb = 0; mb < CAN_TX_MAILBOXES; mb++) {
+        if (txbusy_[mb] && !txabort_[mb]
+            && txcnt_ + txInFlight(true) < CAN_TX_FRAMES_MAX) {
+            // [23] ABRQ2, [15] ABRQ1, [7] ABRQ0: abort request
+            write32(&dev_->TSR.val, 1ul << (7 + 8 * mb));
+            txabort_[mb] = true;
+        }
+    }
+    RestoreIrq(primask);
+
+    // Frame already on the bus is completed before the mailbox is empty
+    if (fw_wait_poll(can_tx_empty, dev_, CAN_INIT_TIMEOUT_US) != 0) {
+        uart_printf("%s: tx abort timeout\r\n", ObjectName());
+    }
+    // Requeue or account the aborted mailboxes if irq is not served yet
+    handleTxInterrupt();
+
+    SetBaudrated(baudrate_.to_uint32());
+
+    primask = DisableIrqSave();
+    txhold_ = false;
+    if (silent_.to_int8()) {
+        txdrop_.make_uint32(txdrop_.to_uint32() + txcnt_);
+        txcnt_ = 0;
+    } else {
+        txRefill();
+    }
+    RestoreIrq(primask);
+}
+
 void CanDriver::SetBaudrated(uint32_t baud) {
     CAN_MCR_type mcr;
-    CAN_MSR_type msr;
     CAN_BTR_type btr;
 
     mcr.val = 0;
     mcr.b.INRQ = 1;
     write32(&dev_->MCR.val, mcr.val);
 
-    // wait entering initialzation stage
-    do {
-        msr.val = read32(&dev_->MSR.val);
-    } while (msr.b.INAK == 0);
+    // wait entering initialzation stage and leaving sleep mode
+    if (fw_wait_poll(can_init_ack, dev_, CAN_INIT_TIMEOUT_US) != 0) {
+        uart_printf("%s: init mode timeout\r\n", ObjectName());
+        return;
+    }
 
     // Let's make 12 samples per bit (example 500KBaud * 12 = 6MHz)
     uint32_t pclk = (uint32_t)system_clock_hz() / 4;    // APB1: 144/4 = 36 MHz 
@@ -277,7 +398,7 @@ void CanDriver::SetBaudrated(uint32_t baud) {
     btr.b.TS1 = 8 - 1;
     btr.b.TS2 = 3 - 1;
     btr.b.SJW = 1 - 1;   // tuning value of BS1/BS2 if the edge detected outside of sync interval
-    btr.b.SILM = 1;      // silent mode
+    btr.b.SILM = silent_.to_int8() ? 1 : 0;   // silent mode
     write32(&dev_->BTR.val, btr.val);
 
     // Switch to Normal mode
@@ -287,32 +408,85 @@ void CanDriver::SetBaudrated(uint32_t baud) {
     baudrate_.make_int32(baud);
 }
 
+/**
+ * @brief Convert RIR/TIR register format [31:21] STID, [20:3] EXID, [2] IDE
+ *        into can_frame_type::id with the explicit CAN_ID_EXT flag
+ */
 uint32_t CanDriver::hwid2canid(uint32_t hwid) {
-    uint32_t ret = (hwid >> 3);
-    return ret;
+    if (hwid & 0x4) {
+        return CAN_ID_EXT | ((hwid >> 3) & 0x1FFFFFFF);
+    }
+    return hwid >> 21;
+}
+
+uint32_t CanDriver::canid2hwid(uint32_t canid) {
+    if (canid & CAN_ID_EXT) {
+        return ((canid & 0x1FFFFFFF) << 3) | 0x4;
+    }
+    return (canid & 0x7FF) << 21;
+}
+
+/**
+ * @brief Bus error interrupt. Called from SCE irq handler.
+ */
+void CanDriver::handleError() {
+    CAN_ESR_type esr;
+    // [6:4] LEC. Last Error Code
+    //      000 No error
+    //      001 Stuff error
+    //      010 Form error
+    //      011 Ack error
+    //      100 Bit recessive error
+    //      101 Bit dominant error
+    //      110 CRC error
+    //      111 Set by software
+    // [2] BOFF. Bus off flag
+    // [1] EPVF. Error passive flag
+    // [0] EWGF. Error warning flag
+    esr.val = read32(&dev_->ESR.val);
+    errcnt_.make_uint32(errcnt_.to_uint32() + 1);
+    lasterr_.make_uint32(esr.val);
 }
 
 void CanDriver::handleInterrupt(int *argv) {
     CAN_RF_type rf;
     can_frame_type *f;
     int fifoidx = argv[0];
+    int freecnt;
+    uint32_t cnt;
+
+    if (fifoidx == IRQ_SCE) {
+        handleError();
+        return;
+    }
+    if (fifoidx == IRQ_TX) {
+        handleTxInterrupt();
+        return;
+    }
+
+    // Hardware 3-frames FIFO was overrun before the interrupt was served
+    rf.val = read32(&dev_->RF[fifoidx].val);
+    if (rf.b.FOVR) {
+        rxovr_.make_uint32(rxovr_.to_uint32() + 1);
+        rf.val = 0;
+        rf.b.FOVR = 1;      // RC_W1
+        write32(&dev_->RF[fifoidx].val, rf.val);
+    }
 
     do {
-        f = &rxframes[rxframe_wcnt];
-        // TODO fifo: is full
-        if (rxframe_wcnt != rxframe_rcnt) {
-            if (++rxframe_wcnt >= CAN_RX_FRAMES_MAX) {
-                rxframe_wcnt = 0;
-            }
+        // Decode frame in place directly into the ring
+        f = reinterpret_cast<can_frame_type *>(
+                fw_ring_write_peek(&rxring_, &freecnt));
+        if (freecnt == 0) {
+            f = &rxoverflow_;
         }
-        
+
         f->busid = busid_;
         f->id = read32(&dev_->sFIFOMailBox[fifoidx].RIR);
         f->id = hwid2canid(f->id);
 
-        f->timestamp = read32(&dev_->sFIFOMailBox[fifoidx].RDTR);
-        f->dlc = (uint8_t)(f->timestamp & 0xF);
-        f->timestamp >>= 16;
+        f->timestamp = fw_clock_get_us32();
+        f->dlc = (uint8_t)(read32(&dev_->sFIFOMailBox[fifoidx].RDTR) & 0xF);
 
         f->data.u32[0] = read32(&dev_->sFIFOMailBox[fifoidx].RDLR);
         f->data.u32[1] = read32(&dev_->sFIFOMailBox[fifoidx].RDHR);
@@ -323,110 +497,211 @@ void CanDriver::handleInterrupt(int *argv) {
 
         rf.val = read32(&dev_->RF[fifoidx].val);
         rxcnt_.increment();
-
-        // Detect and read PGM state
-        if ((f->id & 0x1f00601f) == 0x1f00601f)
-        {
-            // 1_1111_0000_0000_0110_0000_0001_1111
-            // hearbeat frame:
-            // [12:0]       = rsrv1         0_0000_0001_1111
-            // [14:13]      = frametype     11=heartbeat 01=targetframe; 00=BC-frame
-            // [19:15]      = rsrv2         0000_0
-            // [23:21]      = source        000
-            // [28:24]      = bctype        0=SBC-frame; 8=MBC-frame
-
-            // Data frame
-            // [28:25]      = channel       1_111
-            // {[24],[7:5]} = subchannel    1...1000
-            // [23,16]      = target        0000_0000
-            // [15:8]       = sender        0110_0000 (always const in heartbeat)
-            // [7:5] see subchann
-            // [4:0]        = counter       1_1111
-            //uart_printk("%d %02x %02x %02x\r\n", busid_, (f->id>>16) & 0xFF, f->data.u8[1]);
-            pgm_.make_int8(f->data.u8[1]);
-        } else if ((f->id & 0x1e000000) == 0x1a000000) {
-            int cpuidx = CPU_Unknown;
-            DebugMessageType *msg;
-            switch ((f->id >> 8) & 0xFF) {
-            case 0xA3:
-                cpuidx = CPU_M1;
-                break;
-            case 0x23:
-                cpuidx = CPU_M2;
-                break;
-            case 0xA5:
-                cpuidx = CPU_A1;
-                break;
-            case 0x25:
-                cpuidx = CPU_A2;
-                break;
-            case 0xA6:
-                cpuidx = CPU_B1;
-                break;
-            case 0x26:
-                cpuidx = CPU_B2;
-                break;
-            case 0xA8:
-                cpuidx = CPU_D1;
-                break;
-            case 0x28:
-                cpuidx = CPU_D2;
-                break;
-            default:;
-            }
-            msg = &dbgmsg_[cpuidx];
-            for (uint8_t i = 0; i < f->dlc; i++) {
-                if (msg->cnt >= static_cast<int>(sizeof(msg->buf) - 1)) {
-                    break;
-                }
-                msg->buf[msg->cnt++] = f->data.s8[i];
-                msg->buf[msg->cnt] = 0;
+        if (freecnt != 0) {
+            fw_ring_write_commit(&rxring_, 1);
+            cnt = static_cast<uint32_t>(fw_ring_get_count(&rxring_));
+            if (cnt > rxhwm_.to_uint32()) {
+                rxhwm_.make_uint32(cnt);
             }
-            if ((f->id & 0x1f) == 0x1f) {
-                // the last msg in a sequence
-                char *tbuf = msg_history_.buf[msg_history_.pos++];
-                if (msg_history_.pos >= CAN_MSG_HISTORY_LENGTH) {
-                    msg_history_.pos = 0;
-                }
-                for (int i = 0; i <= msg->cnt; i++) {
-                    tbuf[i] = msg->buf[i];
-                }
-                for (int i = msg->cnt; i < 30; i++) {   // 20 symbols of 24; 30 of 16 and 40 of 12
-                    tbuf[i] = ' ';
-                }
-                tbuf[30] = 0;
-                msg_history_.total++;
-                msg->buf[3] = 0;
-                msg->cnt = 3;
+        } else {
+            rxdrop_.make_uint32(rxdrop_.to_uint32() + 1);
+        }
+
+        // PGM state and debug strings are parsed in the worker task
+        if ((f->id & CAN_SVC_PGM_MASK) == CAN_SVC_PGM_ID
+            || (f->id & CAN_SVC_DBG_MASK) == CAN_SVC_DBG_ID) {
+            if (fw_ring_write(&svcring_, f, 1) != 0) {
+                fw_work_post(FW_WORK_HIGH, serviceWork, this, 0);
+            } else {
+                svcdrop_.make_uint32(svcdrop_.to_uint32() + 1);
             }
         }
     } while (rf.b.FMP != 0);
+
+    // One posted work item drains all frames received until it runs
+    if (hasListeners_ && !dispatchPending_) {
+        dispatchPending_ = true;
+        if (!fw_work_post(FW_WORK_HIGH, dispatchWork, this, 0)) {
+            dispatchPending_ = false;
+        }
+    }
 }
 
-// Total 18 filters available
-void CanDriver::StartListenerMode() {
-    uint32_t t1;
+void CanDriver::dispatchWork(void *ctx, uint32_t arg) {
+    CanDriver *p = static_cast<CanDriver *>(ctx);
+    can_frame_type frames[CAN_DISPATCH_BATCH];
+    int cnt;
 
-    // Registers 0x200... exist only in CAN1
-    if (busid_ == 0) {
-        // [13:8] CAN2FSB: 0=no assigned filters to CAN1, 28=all filters assigned to CAN1
-        // [0] FINIT
-        write32(&dev_->FMR, (14 << 8) | 1);          // Assign filters[0..13] to CAN1; [14..27] to CAN2
-        write32(&dev_->FM1R, 0);                     // all filters in Mask mode=0; 1=List mode
-        write32(&dev_->FFA1R, 0x3f80 | (0x3f80 << 14));               // 0 Fillter assigned to FIFO0; 1 assigned to FIFO1
+    // Cleared before draining so that a frame received after the last
+    // read posts the new work item
+    p->dispatchPending_ = false;
+    while ((cnt = fw_ring_read(&p->rxring_, frames, CAN_DISPATCH_BATCH)) != 0) {
+        for (int i = 0; i < cnt; i++) {
+            p->dispatchFrame(&frames[i]);
+        }
+        // Polling consumer gets its own copy, rxring_ stays single consumer
+        if (p->pollActive_) {
+            cnt -= fw_ring_write(&p->pollring_, frames, cnt);
+            p->polldrop_.make_uint32(p->polldrop_.to_uint32() + cnt);
+        }
+    }
+}
+
+void CanDriver::dispatchFrame(can_frame_type *f) {
+    CanSubscription *p;
+
+    p = reinterpret_cast<CanSubscription *>(
+            fw_hash_table_find(&exact_, can_id_hash(f->id), &f->id, subscriptionMatch));
+    while (p) {
+        p->iface->CanCallback(f);
+        p = p->next;
+    }
+
+    p = masked_;
+    while (p) {
+        if ((f->id & p->mask) == (p->id & p->mask)) {
+            p->iface->CanCallback(f);
+        }
+        p = p->next;
+    }
+}
+
+int CanDriver::subscriptionMatch(void *payload, const void *key) {
+    uint32_t id = *reinterpret_cast<const uint32_t *>(key);
+    return reinterpret_cast<CanSubscription *>(payload)->id == id;
+}
+
+void CanDriver::RegisterCanListener(CanListenerInterface *iface) {
+    RegisterCanListener(iface, 0, 0);
+}
+
+void CanDriver::RegisterCanListener(CanListenerInterface *iface,
+                                    uint32_t id,
+                                    uint32_t mask) {
+    CanSubscription *item = reinterpret_cast<CanSubscription *>(
+                                fw_malloc(sizeof(CanSubscription)));
+    CanSubscription **pnext;
+
+    if (item == 0) {
+        return;
+    }
+    item->id = id & mask;
+    item->mask = mask;
+    item->iface = iface;
+    item->next = 0;
+
+    if (mask == 0xFFFFFFFF) {
+        CanSubscription *first = reinterpret_cast<CanSubscription *>(
+            fw_hash_table_find(&exact_, can_id_hash(id), &id, subscriptionMatch));
+        if (first == 0) {
+            fw_hash_table_add(&exact_, can_id_hash(id), item);
+        } else {
+            pnext = &first->next;
+            while (*pnext) {
+                pnext = &(*pnext)->next;
+            }
+            *pnext = item;
+        }
+    } else {
+        pnext = &masked_;
+        while (*pnext) {
+            pnext = &(*pnext)->next;
+        }
+        *pnext = item;
+    }
+    hasListeners_ = true;
+    AddAcceptanceFilter(id, mask);
+}
 
-        write32(&dev_->sFilterRegister[0].FR1, 0);   // identifier
-        write32(&dev_->sFilterRegister[0].FR2, 0);   // mask in mask mode
-        write32(&dev_->sFilterRegister[14].FR1, 0);   // identifier
-        write32(&dev_->sFilterRegister[14].FR2, 0);   // mask in mask mode
+void CanDriver::serviceWork(void *ctx, uint32_t arg) {
+    CanDriver *p = static_cast<CanDriver *>(ctx);
+    can_frame_type frame;
+    while (fw_ring_read(&p->svcring_, &frame, 1)) {
+        p->processServiceFrame(&frame);
+    }
+}
 
-        write32(&dev_->FA1R, (1 << 0) | (1 << 14));   // [0] FACT0: activate filter 0 (or 14 for CAN1)
+void CanDriver::processServiceFrame(can_frame_type *f) {
+    // Detect and read PGM state
+    if ((f->id & CAN_SVC_PGM_MASK) == CAN_SVC_PGM_ID)
+    {
+        // 1_1111_0000_0000_0110_0000_0001_1111
+        // hearbeat frame:
+        // [12:0]       = rsrv1         0_0000_0001_1111
+        // [14:13]      = frametype     11=heartbeat 01=targetframe; 00=BC-frame
+        // [19:15]      = rsrv2         0000_0
+        // [23:21]      = source        000
+        // [28:24]      = bctype        0=SBC-frame; 8=MBC-frame
 
-        t1 = read32(&dev_->FMR);
-        t1 &= ~1;   // FINIT = 0
-        write32(&dev_->FMR, t1);
+        // Data frame
+        // [28:25]      = channel       1_111
+        // {[24],[7:5]} = subchannel    1...1000
+        // [23,16]      = target        0000_0000
+        // [15:8]       = sender        0110_0000 (always const in heartbeat)
+        // [7:5] see subchann
+        // [4:0]        = counter       1_1111
+        //uart_printk("%d %02x %02x %02x\r\n", busid_, (f->id>>16) & 0xFF, f->data.u8[1]);
+        pgm_.make_int8(f->data.u8[1]);
+    } else if ((f->id & CAN_SVC_DBG_MASK) == CAN_SVC_DBG_ID) {
+        int cpuidx = CPU_Unknown;
+        DebugMessageType *msg;
+        switch ((f->id >> 8) & 0xFF) {
+        case 0xA3:
+            cpuidx = CPU_M1;
+            break;
+        case 0x23:
+            cpuidx = CPU_M2;
+            break;
+        case 0xA5:
+            cpuidx = CPU_A1;
+            break;
+        case 0x25:
+            cpuidx = CPU_A2;
+            break;
+        case 0xA6:
+            cpuidx = CPU_B1;
+            break;
+        case 0x26:
+            cpuidx = CPU_B2;
+            break;
+        case 0xA8:
+            cpuidx = CPU_D1;
+            break;
+        case 0x28:
+            cpuidx = CPU_D2;
+            break;
+        default:;
+        }
+        msg = &dbgmsg_[cpuidx];
+        for (uint8_t i = 0; i < f->dlc; i++) {
+            if (msg->cnt >= static_cast<int>(sizeof(msg->buf) - 1)) {
+                break;
+            }
+            msg->buf[msg->cnt++] = f->data.s8[i];
+            msg->buf[msg->cnt] = 0;
+        }
+        if ((f->id & 0x1f) == 0x1f) {
+            // the last msg in a sequence
+            char *tbuf = msg_history_.buf[msg_history_.pos++];
+            if (msg_history_.pos >= CAN_MSG_HISTORY_LENGTH) {
+                msg_history_.pos = 0;
+            }
+            for (int i = 0; i <= msg->cnt; i++) {
+                tbuf[i] = msg->buf[i];
+            }
+            for (int i = msg->cnt; i < 30; i++) {   // 20 symbols of 24; 30 of 16 and 40 of 12
+                tbuf[i] = ' ';
+            }
+            tbuf[30] = 0;
+            msg_history_.total++;
+            msg->buf[3] = 0;
+            msg->cnt = 3;
+        }
     }
+}
 
+void CanDriver::StartListenerMode() {
+    ApplyAcceptanceFilters();
 
     // Enable Rx interrupts in FIFO0 and FIFO1
     setRun();
@@ -442,6 +717,7 @@ void CanDriver::setRun() {
     ier.b.FMPIE1 = 1;
     ier.b.ERRIE = 1;
     ier.b.LECIE = 1;    // Last Error code interrupt
+    ier.b.TMEIE = 1;    // Tx mailbox request completed
     //ier.b.BOFIE = 1;    // Bus-off interrupt
     //ier.b.EPVIE = 1;    // Error passive interrupt
     //ier.b.EWGIE = 1;    // Error warning interrupt
@@ -452,21 +728,422 @@ void CanDriver::setStop() {
     write32(&dev_->IER.val, 0);  // disable all interrupts
 }
 
-// TODO: fifo
+void CanDriver::AddAcceptanceFilter(uint32_t id, uint32_t mask) {
+    CanFilterEntry e;
+
+    if (mask == 0xFFFFFFFF) {
+        e.fr = canid2hwid(id);
+        e.mask = CAN_FILTER_EXACT;
+    } else {
+        // Identifier bits in the format of the id, [1] RTR: data frames
+        // only, [2] IDE compared if CAN_ID_EXT is set in the mask
+        e.fr = canid2hwid(id & (mask | CAN_ID_EXT)) & ~0x4u;
+        e.mask = canid2hwid((id & CAN_ID_EXT) | (mask & ~CAN_ID_EXT));
+        e.mask = (e.mask & ~0x4u) | 0x2;
+        if (mask & CAN_ID_EXT) {
+            e.fr |= canid2hwid(id) & 0x4;
+            e.mask |= 0x4;
+        }
+    }
+    for (int i = 0; i < wantedcnt_; i++) {
+        if (wanted_[i].fr == e.fr && wanted_[i].mask == e.mask) {
+            return;
+        }
+    }
+    if (wantedcnt_ < CAN_FILTERS_WANTED_MAX) {
+        wanted_[wantedcnt_++] = e;
+    } else {
+        wantedOverflow_ = true;
+    }
+    if (filtersApplied_) {
+        ApplyAcceptanceFilters();
+    }
+}
+
+void CanDriver::ApplyAcceptanceFilters() {
+    CanFilterEntry e[CAN_FILTERS_WANTED_MAX + 1];
+    int cnt = 0;
+    int merges = 0;
+    int banks;
+
+    if (wantedcnt_ == 0 || wantedOverflow_) {
+        // Nothing to select or the list is lost: accept all frames
+        e[0].fr = 0;
+        e[0].mask = 0;
+        cnt = 1;
+    } else {
+        memcpy(e, wanted_, wantedcnt_ * sizeof(CanFilterEntry));
+        cnt = wantedcnt_;
+    }
+
+    while ((banks = filterBanks(e, cnt)) > CAN_FILTER_BANKS) {
+        mergeClosestFilters(e, &cnt);
+        merges++;
+    }
+    programFilters(e, cnt);
+    fltutil_.make_uint32((merges << 16) | (CAN_FILTER_BANKS << 8) | banks);
+}
+
+int CanDriver::filterBanks(CanFilterEntry *e, int cnt) {
+    int total[3] = {0};
+    for (int i = 0; i < cnt; i++) {
+        total[can_filter_kind(e[i].fr, e[i].mask)]++;
+    }
+    return can_filter_banks(total[FILTER_STD_ID],
+                            total[FILTER_EXT_ID],
+                            total[FILTER_MASK]);
+}
+
+/**
+ * @brief Replace two entries by one mask entry. The pair is selected to
+ *        minimize the number of banks and then to keep the most of the
+ *        significant bits (the least of extra accepted frames).
+ */
+void CanDriver::mergeClosestFilters(CanFilterEntry *e, int *cnt) {
+    int total[3] = {0};
+    int t[3];
+    int besti = 0;
+    int bestj = 1;
+    int bestbanks = CAN_FILTERS_WANTED_MAX + 1;
+    int bestbits = -1;
+    int banks;
+    int bits;
+    uint32_t m;
+
+    for (int i = 0; i < *cnt; i++) {
+        total[can_filter_kind(e[i].fr, e[i].mask)]++;
+    }
+    for (int i = 0; i < *cnt; i++) {
+        for (int j = i + 1; j < *cnt; j++) {
+            m = e[i].mask & e[j].mask & ~(e[i].fr ^ e[j].fr);
+            t[0] = total[0];
+            t[1] = total[1];
+            t[2] = total[2];
+            t[can_filter_kind(e[i].fr, e[i].mask)]--;
+            t[can_filter_kind(e[j].fr, e[j].mask)]--;
+            t[can_filter_kind(e[i].fr & m, m)]++;
+            banks = can_filter_banks(t[0], t[1], t[2]);
+            bits = can_bits_count(m);
+            if (banks < bestbanks || (banks == bestbanks && bits > bestbits)) {
+                besti = i;
+                bestj = j;
+                bestbanks = banks;
+                bestbits = bits;
+            }
+        }
+    }
+    m = e[besti].mask & e[bestj].mask & ~(e[besti].fr ^ e[bestj].fr);
+    e[besti].mask = m;
+    e[besti].fr &= m;
+    e[bestj] = e[--(*cnt)];
+}
+
+void CanDriver::programFilters(CanFilterEntry *e, int cnt) {
+    // Filter registers exist only in CAN1, banks [14..27] belong to CAN2
+    CAN_registers_type *fdev = (CAN_registers_type *)CAN1_BASE;
+    int bank = busid_ * CAN_FILTER_BANKS;
+    uint32_t own = ((1ul << CAN_FILTER_BANKS) - 1) << bank;
+    uint32_t fm1r;
+    uint32_t fs1r;
+    uint32_t ffa1r;
+    uint32_t fa1r;
+    uint32_t bit;
+    uint16_t id16[4];
+    uint32_t id32[2];
+    int n16 = 0;
+    int n32 = 0;
+    int kind;
+
+    // [13:8] CAN2SB: first bank of CAN2; [0] FINIT: initialization mode
+    write32(&fdev->FMR, (CAN_FILTER_BANKS << 8) | 1);
+    fa1r = read32(&fdev->FA1R) & ~own;
+    write32(&fdev->FA1R, fa1r);
+    fm1r = read32(&fdev->FM1R) & ~own;      // 0=mask; 1=list mode
+    fs1r = read32(&fdev->FS1R) & ~own;      // 0=dual 16-bit; 1=single 32-bit
+    ffa1r = read32(&fdev->FFA1R) & ~own;    // 0=FIFO0; 1=FIFO1
+
+    // Lists are completed by the duplicates of the first entry
+    for (int i = 0; i <= cnt; i++) {
+        kind = i < cnt ? can_filter_kind(e[i].fr, e[i].mask) : -1;
+        if (kind == FILTER_STD_ID) {
+            // [15:5] STID, [4] RTR, [3] IDE, [2:0] EXID[17:15]
+            id16[n16++] = static_cast<uint16_t>((e[i].fr >> 21) << 5);
+        } else if (kind == FILTER_EXT_ID) {
+            id32[n32++] = e[i].fr;
+        }
+        bit = 1ul << bank;
+        if (n16 == 4 || (kind == -1 && n16 != 0)) {
+            while (n16 < 4) {
+                id16[n16++] = id16[0];
+            }
+            write32(&fdev->sFilterRegister[bank].FR1,
+                    id16[0] | (static_cast<uint32_t>(id16[1]) << 16));
+            write32(&fdev->sFilterRegister[bank].FR2,
+                    id16[2] | (static_cast<uint32_t>(id16[3]) << 16));
+            fm1r |= bit;
+            n16 = 0;
+        } else if (n32 == 2 || (kind == -1 && n32 != 0)) {
+            if (n32 < 2) {
+                id32[1] = id32[0];
+            }
+            write32(&fdev->sFilterRegister[bank].FR1, id32[0]);
+            write32(&fdev->sFilterRegister[bank].FR2, id32[1]);
+            fm1r |= bit;
+            fs1r |= bit;
+            n32 = 0;
+        } else if (kind == FILTER_MASK) {
+            write32(&fdev->sFilterRegister[bank].FR1, e[i].fr);
+            write32(&fdev->sFilterRegister[bank].FR2, e[i].mask);
+            fs1r |= bit;
+        } else {
+            continue;
+        }
+        // Balance two hardware FIFOs
+        if (bank & 1) {
+            ffa1r |= bit;
+        }
+        fa1r |= bit;
+        bank++;
+        if (kind == -1 && (n16 != 0 || n32 != 0)) {
+            i--;        // flush the second partial list
+        }
+    }
+
+    write32(&fdev->FM1R, fm1r);
+    write32(&fdev->FS1R, fs1r);
+    write32(&fdev->FFA1R, ffa1r);
+    write32(&fdev->FA1R, fa1r);
+    write32(&fdev->FMR, CAN_FILTER_BANKS << 8);     // FINIT = 0
+}
+
 int CanDriver::ReadCanFrame(can_frame_type *frame) {
-    int total = rxframe_wcnt - rxframe_rcnt - 1;
-    if (total < 0) {
-        total += CAN_RX_FRAMES_MAX;
-    } else if (total >= CAN_RX_FRAMES_MAX)  {
-        total -= CAN_RX_FRAMES_MAX;
-    }
-    
-    if (total == 0) {
+    return ReadCanFrames(frame, 1);
+}
+
+int CanDriver::ReadCanFrames(can_frame_type *frames, int max) {
+    // Single consumer ring: owned by dispatchWork() once listeners exist,
+    // then frames are copied into pollring_ from the first call
+    if (hasListeners_) {
+        pollActive_ = true;
+        return fw_ring_read(&pollring_, frames, max);
+    }
+    return fw_ring_read(&rxring_, frames, max);
+}
+
+int CanDriver::WriteCanFrame(can_frame_type *frame) {
+    CanTxEntry e;
+    uint32_t primask;
+
+    // Listen only mode: neither data frames nor ACK are sent
+    if (silent_.to_int8()) {
         return 0;
     }
-    if (++rxframe_rcnt >= CAN_RX_FRAMES_MAX) {
-        rxframe_rcnt = 0;
+    e.frame = *frame;
+    primask = DisableIrqSave();
+    // Mailbox frames may be aborted and requeued, reserve their slots
+    if (txcnt_ + txInFlight(false) >= CAN_TX_FRAMES_MAX) {
+        txdrop_.make_uint32(txdrop_.to_uint32() + 1);
+        RestoreIrq(primask);
+        return 0;
     }
-    *frame = rxframes[rxframe_rcnt];
+    e.seq = txseq_++;
+    txPush(&e);
+    txRefill();
+    RestoreIrq(primask);
     return 1;
 }
+
+/**
+ * @brief Lower CAN ID wins the bus arbitration, frames with the same ID are
+ *        sent in order of WriteCanFrame() calls.
+ */
+bool CanDriver::txBefore(const CanTxEntry *a, const CanTxEntry *b) {
+    // Register format is in the arbitration order: STID, then IDE, EXID
+    uint32_t ida = canid2hwid(a->frame.id);
+    uint32_t idb = canid2hwid(b->frame.id);
+    if (ida != idb) {
+        return ida < idb;
+    }
+    return static_cast<int32_t>(a->seq - b->seq) < 0;
+}
+
+void CanDriver::txPush(const CanTxEntry *e) {
+    int idx = txcnt_++;
+    int parent;
+    while (idx > 0) {
+        parent = (idx - 1) >> 1;
+        if (!txBefore(e, &txheap_[parent])) {
+            break;
+        }
+        txheap_[idx] = txheap_[parent];
+        idx = parent;
+    }
+    txheap_[idx] = *e;
+}
+
+void CanDriver::txPop(CanTxEntry *e) {
+    CanTxEntry *last = &txheap_[--txcnt_];
+    int idx = 0;
+    int child;
+
+    *e = txheap_[0];
+    while ((child = 2 * idx + 1) < txcnt_) {
+        if (child + 1 < txcnt_ && txBefore(&txheap_[child + 1], &txheap_[child])) {
+            child++;
+        }
+        if (!txBefore(&txheap_[child], last)) {
+            break;
+        }
+        txheap_[idx] = txheap_[child];
+        idx = child;
+    }
+    txheap_[idx] = *last;
+}
+
+void CanDriver::txLoad(int mb, const CanTxEntry *e) {
+    CAN_txmailbox_type *m = &dev_->sTxMailBox[mb];
+    uint32_t tir = canid2hwid(e->frame.id);
+
+    write32(&m->TIR, tir);
+    write32(&m->TDTR, e->frame.dlc & 0xF);
+    write32(&m->TDLR, e->frame.data.u32[0]);
+    write32(&m->TDHR, e->frame.data.u32[1]);
+    write32(&m->TIR, tir | 1);      // [0] TXRQ: transmit request
+    txmbox_[mb] = *e;
+    txbusy_[mb] = true;
+    txabort_[mb] = false;
+}
+
+/**
+ * @brief Fill empty mailboxes from the queue head. When all mailboxes are
+ *        busy and the queue head has higher priority than the lowest
+ *        priority pending frame, that frame is aborted and requeued to
+ *        avoid priority inversion. Called with disabled interrupts.
+ */
+void CanDriver::txRefill() {
+    CanTxEntry e;
+    uint32_t tsr = read32(&dev_->TSR.val);
+    int lowest = -1;
+
+    if (txhold_) {
+        return;
+    }
+    for (int mb = 0; mb < CAN_TX_MAILBOXES && txcnt_ > 0; mb++) {
+        // [28:26] TME2..TME0: mailbox is empty
+        if ((tsr & (1ul << (26 + mb))) && !txbusy_[mb]) {
+            txPop(&e);
+            txLoad(mb, &e);
+        }
+    }
+    if (txcnt_ == 0) {
+        return;
+    }
+    for (int mb = 0; mb < CAN_TX_MAILBOXES; mb++) {
+        if (!txbusy_[mb] || txabort_[mb]) {
+            continue;
+        }
+        if (lowest < 0 || txBefore(&txmbox_[lowest], &txmbox_[mb])) {
+            lowest = mb;
+        }
+    }
+    if (lowest >= 0 && txBefore(&txheap_[0], &txmbox_[lowest])
+        && txcnt_ + txInFlight(true) < CAN_TX_FRAMES_MAX) {
+        // [23] ABRQ2, [15] ABRQ1, [7] ABRQ0: abort request
+        write32(&dev_->TSR.val, 1ul << (7 + 8 * lowest));
+        txabort_[lowest] = true;
+    }
+}
+
+/**
+ * @brief Number of loaded mailboxes, or only of the ones with the abort
+ *        request that will be requeued. Called with disabled interrupts.
+ */
+int CanDriver::txInFlight(bool aborted) {
+    int ret = 0;
+    for (int mb = 0; mb < CAN_TX_MAILBOXES; mb++) {
+        if (txbusy_[mb] && (!aborted || txabort_[mb])) {
+            ret++;
+        }
+    }
+    return ret;
+}
+
+void CanDriver::handleTxInterrupt() {
+    uint32_t primask = DisableIrqSave();
+    uint32_t tsr = read32(&dev_->TSR.val);
+    uint32_t bits;
+    CanTxStat *st;
+
+    for (int mb = 0; mb < CAN_TX_MAILBOXES; mb++) {
+        // [0] RQCP, [1] TXOK, [2] ALST, [3] TERR of each mailbox
+        bits = (tsr >> (8 * mb)) & 0xF;
+        if ((bits & 0x1) == 0 || !txbusy_[mb]) {
+            continue;
+        }
+        write32(&dev_->TSR.val, 1ul << (8 * mb));   // RC_W1 clears all status bits
+        st = txStat(txmbox_[mb].frame.id, true);
+        if (bits & 0x2) {
+            st->sent++;
+            st->timestamp = fw_clock_get_us32();
+        } else if (txabort_[mb] && txcnt_ < CAN_TX_FRAMES_MAX) {
+            // Keeps original sequence number to stay ahead of the same ID
+            txPush(&txmbox_[mb]);
+            st->aborted++;
+        } else if (txabort_[mb]) {
+            txdrop_.make_uint32(txdrop_.to_uint32() + 1);
+        } else {
+            st->errors++;
+        }
+        txbusy_[mb] = false;
+        txabort_[mb] = false;
+    }
+    txRefill();
+    RestoreIrq(primask);
+}
+
+CanDriver::CanTxStat *CanDriver::txStat(uint32_t id, bool create) {
+    uint32_t idx = can_id_hash(id) & (CAN_TX_STAT_MAX - 1);
+    for (int i = 0; i < CAN_TX_STAT_MAX; i++) {
+        CanTxStat *p = &txids_[idx];
+        if (p->used && p->id == id) {
+            return p;
+        }
+        if (!p->used) {
+            if (!create) {
+                return 0;
+            }
+            p->used = true;
+            p->id = id;
+            return p;
+        }
+        idx = (idx + 1) & (CAN_TX_STAT_MAX - 1);
+    }
+    return create ? &txother_ : 0;
+}
+
+void CanDriver::TxStatAttribute::post_write() {
+    if (selector_ == 0) {
+        id_ = u_.u32;
+    }
+}
+
+void CanDriver::TxStatAttribute::pre_read() {
+    uint32_t primask = DisableIrqSave();
+    uint32_t id = selector_ ? selector_->id_ : id_;
+    CanTxStat *st = parent_->txStat(id, false);
+    uint32_t sent;
+    uint32_t aborted;
+    uint32_t errors;
+
+    if (st == 0) {
+        u_.u32 = 0;
+    } else if (selector_) {
+        u_.u32 = st->timestamp;
+    } else {
+        sent = st->sent > 0xFFFF ? 0xFFFF : st->sent;
+        aborted = st->aborted > 0xFF ? 0xFF : st->aborted;
+        errors = st->errors > 0xFF ? 0xFF : st->errors;
+        u_.u32 = (errors << 24) | (aborted << 16) | sent;
+    }
+    RestoreIrq(primask);
+}
@@ -19,6 +19,8 @@
 #include <fwlist.h>
 #include <fwobject.h>
 #include <FwAttribute.h>
+#include <fwring.h>
+#include <fwhash.h>
 #include <RunInterface.h>
 #include <CanInterface.h>
 #include <IrqInterface.h>
@@ -30,7 +32,13 @@ class CanDriver : public FwObject,
                   public CanInterface,
                   public IrqHandlerInterface {
  public:
-    CanDriver(const char *name, int busid);
+    /**
+     * @param[in] rxdepth Receive ring capacity in frames, rounded up to
+     *                    power of 2. Sized by the application kernel.
+     */
+    CanDriver(const char *name, int busid, int rxdepth = CAN_RX_FRAMES_DEFAULT);
+
+    static const int CAN_RX_FRAMES_DEFAULT = 16;
 
     // FwObject interface:
     virtual void Init() override;
@@ -44,23 +52,67 @@ class CanDriver : public FwObject,
     // CanInterface:
     virtual void SetBaudrated(uint32_t baud) override;
     virtual void StartListenerMode() override;
-    virtual void RegisterCanListener(CanListenerInterface *iface) override {}
+    virtual void RegisterCanListener(CanListenerInterface *iface) override;
+    virtual void RegisterCanListener(CanListenerInterface *iface,
+                                     uint32_t id,
+                                     uint32_t mask) override;
+    virtual void AddAcceptanceFilter(uint32_t id, uint32_t mask) override;
+    virtual void ApplyAcceptanceFilters() override;
     virtual int ReadCanFrame(can_frame_type *frame) override;
+    virtual int ReadCanFrames(can_frame_type *frames, int max) override;
+    virtual int WriteCanFrame(can_frame_type *frame) override;
 
-    // IrqHandlerInterface
+    // IrqHandlerInterface: argv[0] is one of IrqSource
     virtual void handleInterrupt(int *argv) override;
 
+    enum IrqSource {
+        IRQ_FIFO0 = 0,
+        IRQ_FIFO1 = 1,
+        IRQ_SCE = 2,
+        IRQ_TX = 3
+    };
+
     // Common methods
     virtual void triggerError();
+    // Re-init with the new 'silent' value without losing pending frames
+    virtual void setSilent();
 
  protected:
-    virtual uint32_t hwid2canid(uint32_t hwid);
+    static uint32_t hwid2canid(uint32_t hwid);
+    static uint32_t canid2hwid(uint32_t canid);
+    virtual void handleError();
+    virtual void processServiceFrame(can_frame_type *f);
+
+    // Deferred work handler (fwwork.h): drain svcring_ in task context
+    static void serviceWork(void *ctx, uint32_t arg);
+    // Deferred work handler: drain rxring_ into the registered listeners
+    static void dispatchWork(void *ctx, uint32_t arg);
+    virtual void dispatchFrame(can_frame_type *f);
+    // fw_hash_table_find() callback: exact ID of the subscription
+    static int subscriptionMatch(void *payload, const void *key);
+
+    /**
+        Acceptance filter entry in the register format (FR1 layout of
+        32-bit scale): [31:21] STID, [20:3] EXID, [2] IDE, [1] RTR
+     */
+    struct CanFilterEntry {
+        uint32_t fr;
+        uint32_t mask;
+    };
+    static const uint32_t CAN_FILTER_EXACT = 0xFFFFFFFE;
+    static const int CAN_FILTER_BANKS = 14;         // banks per bus
+    static const int CAN_FILTERS_WANTED_MAX = 32;
+
+    int filterBanks(CanFilterEntry *e, int cnt);
+    void mergeClosestFilters(CanFilterEntry *e, int *cnt);
+    void programFilters(CanFilterEntry *e, int cnt);
 
     class ErrTriggerAttribute : public FwAttribute {
      public:
         ErrTriggerAttribute(CanDriver *parent, const char *name)
             : FwAttribute(name) , parent_(parent) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void post_write() override {
             parent_->triggerError();
         }
@@ -68,10 +120,47 @@ class CanDriver : public FwObject,
         CanDriver *parent_;
     };
 
+    class SilentAttribute : public FwAttribute {
+     public:
+        SilentAttribute(CanDriver *parent, const char *name)
+            : FwAttribute(name, "1=listen only; 0=normal mode with Tx and ACK"),
+            parent_(parent) {}
+
+        virtual bool isPackable() override { return false; }
+        virtual void post_write() override {
+            parent_->setSilent();
+        }
+     protected:
+        CanDriver *parent_;
+    };
+
+    /**
+        Per-ID transmit statistic: write CAN ID into the counters attribute,
+        then read counters and the timestamp attribute (selector is set).
+     */
+    class TxStatAttribute : public FwAttribute {
+     public:
+        TxStatAttribute(CanDriver *parent, const char *name, const char *descr,
+                        TxStatAttribute *selector)
+            : FwAttribute(name, descr), parent_(parent),
+            selector_(selector), id_(0) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+        virtual void post_write() override;
+     protected:
+        CanDriver *parent_;
+        TxStatAttribute *selector_;     // zero for the counters attribute
+        uint32_t id_;
+    };
+
     class RxCounterAttribute : public FwAttribute {
      public:
         RxCounterAttribute(const char *name) : FwAttribute(name), last_(0) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override {
             u_.u32 -= last_;
             last_ = u_.u32;
@@ -90,17 +179,99 @@ class CanDriver : public FwObject,
     FwAttribute errcnt_;
     FwAttribute lasterr_;
     ErrTriggerAttribute errTrigger_;
+    FwAttribute rxdrop_;            // frames dropped on full rxring_
+    FwAttribute rxovr_;             // hardware FIFO overruns (FOVR)
+    FwAttribute rxhwm_;             // rxring_ high-water mark
+    FwAttribute svcdrop_;           // PGM/debug frames dropped on full svcring_
+    FwAttribute polldrop_;          // frames dropped on full pollring_
+    FwAttribute fltutil_;           // [7:0] used banks, [15:8] total, [23:16] merges
+    SilentAttribute silent_;
+    FwAttribute txdrop_;            // frames rejected on full transmit queue
+    TxStatAttribute txstat_;
+    TxStatAttribute txts_;
 
-    static const int CAN_RX_FRAMES_MAX = 4;
+    static const int CAN_SVC_FRAMES_MAX = 8;
+    // PGM heartbeat: [28:24] bctype, [14:13] frametype, [4:0] counter
+    static const uint32_t CAN_SVC_PGM_ID = CAN_ID_EXT | 0x1f00601f;
+    static const uint32_t CAN_SVC_PGM_MASK = CAN_ID_EXT | 0x1f00601f;
+    // Debug strings of the PGM CPUs
+    static const uint32_t CAN_SVC_DBG_ID = CAN_ID_EXT | 0x1a000000;
+    static const uint32_t CAN_SVC_DBG_MASK = CAN_ID_EXT | 0x1e000000;
 
     int busid_;
     gpio_pin_type gpio_cfg_rx_;
     gpio_pin_type gpio_cfg_tx_;
     CAN_registers_type *dev_;
 
-    int rxframe_wcnt;
-    int rxframe_rcnt;
-    can_frame_type rxframes[CAN_RX_FRAMES_MAX];
+    FwRing rxring_;                 // ISR producer, task consumer
+    can_frame_type rxoverflow_;     // frame is parsed but dropped when ring is full
+    FwRing svcring_;                // PGM heartbeat and debug frames for the worker
+    FwRing pollring_;               // dispatchWork -> ReadCanFrames() copy
+
+    /**
+        Listener subscription. Exact IDs are stored in the hash table keyed
+        by ID with the chain of listeners of the same ID, masked entries
+        are in the list scanned for each frame.
+     */
+    struct CanSubscription {
+        uint32_t id;
+        uint32_t mask;
+        CanListenerInterface *iface;
+        CanSubscription *next;
+    };
+    static const int CAN_DISPATCH_BATCH = 8;
+    static const int CAN_POLL_FRAMES_MAX = 16;
+
+    FwHashTable exact_;             // CanSubscription chains per exact ID
+    CanSubscription *masked_;
+    bool hasListeners_;
+    volatile bool dispatchPending_; // dispatchWork is posted but not run yet
+    volatile bool pollActive_;      // ReadCanFrames() called with listeners
+
+    CanFilterEntry wanted_[CAN_FILTERS_WANTED_MAX];
+    int wantedcnt_;
+    bool wantedOverflow_;           // too many entries: accept all frames
+    bool filtersApplied_;           // re-apply on new entries after PostInit
+
+    /**
+        Transmit engine: binary min-heap ordered by (id, seq) feeds three
+        hardware mailboxes from the TME interrupt. All fields are modified
+        with disabled interrupts.
+     */
+    struct CanTxEntry {
+        can_frame_type frame;
+        uint32_t seq;               // FIFO order of the frames with equal ID
+    };
+    struct CanTxStat {
+        uint32_t id;
+        uint32_t sent;
+        uint32_t aborted;
+        uint32_t errors;
+        uint32_t timestamp;         // [us] last transmission complete
+        bool used;
+    };
+    static const int CAN_TX_FRAMES_MAX = 32;
+    static const int CAN_TX_MAILBOXES = 3;
+    static const int CAN_TX_STAT_MAX = 32;      // power of 2
+
+    static bool txBefore(const CanTxEntry *a, const CanTxEntry *b);
+    void txPush(const CanTxEntry *e);
+    void txPop(CanTxEntry *e);
+    void txLoad(int mb, const CanTxEntry *e);
+    void txRefill();
+    int txInFlight(bool aborted);
+    void handleTxInterrupt();
+    CanTxStat *txStat(uint32_t id, bool create);
+
+    CanTxEntry txheap_[CAN_TX_FRAMES_MAX];  // queued + loaded <= CAN_TX_FRAMES_MAX
+    int txcnt_;
+    uint32_t txseq_;
+    CanTxEntry txmbox_[CAN_TX_MAILBOXES];  // frames loaded into mailboxes
+    bool txbusy_[CAN_TX_MAILBOXES];
+    bool txabort_[CAN_TX_MAILBOXES];      // abort requested to requeue
+    bool txhold_;                         // mailboxes are not refilled
+    CanTxStat txids_[CAN_TX_STAT_MAX];
+    CanTxStat txother_;                   // IDs that do not fit into txids_
 
     enum CpuTypes {
         CPU_Unknown,
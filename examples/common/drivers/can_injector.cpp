@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwirq.h>
 #include <uart.h>
 #include <gpio_drv.h>
 #include "can_injector.h"
@@ -45,8 +46,6 @@ static const gpio_pin_type gpio_cfg_injector_ = {
 
 // To reducde IRQ latency sue global variables instead of interface functions:
 CanInjectorDriver *iinjector_ = 0;
-IrqHandlerInterface *drv_can_injector_exti_ = 0;
-IrqHandlerInterface *drv_can_injector_tim_ = 0;
 
 // Called from CAN1 driver Rx irq handler
 extern "C" void CAN1_EndOfFrame() {
@@ -128,8 +127,8 @@ CanInjectorDriver::CanInjectorDriver(const char *name)
 
 void CanInjectorDriver::Init() {
     iinjector_ = this;
-    drv_can_injector_exti_ = static_cast<IrqHandlerInterface *>(this);
-    drv_can_injector_tim_ = static_cast<IrqHandlerInterface *>(&timerStrobHandler_);
+    fw_irq_bind(9, static_cast<IrqHandlerInterface *>(this));    // EXTI3 can1 sof
+    fw_irq_bind(30, static_cast<IrqHandlerInterface *>(&timerStrobHandler_));  // TIM4 inject error bits
 
     RegisterAttribute(&injectAction_);
     RegisterAttribute(&injectCnt_);
@@ -79,6 +79,7 @@ class CanInjectorDriver : public FwObject,
         InjectErrorAction(CanInjectorDriver *parent, const char *name)
             : FwAttribute(name) , parent_(parent) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void post_write() override;
      protected:
         CanInjectorDriver *parent_;
@@ -89,6 +90,7 @@ class CanInjectorDriver : public FwObject,
         InjectErrorCounter(CanInjectorDriver *parent, const char *name)
             : FwAttribute(name) , parent_(parent) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override {
             u_.u32 = parent_->getInjectCnt();
         }
@@ -101,6 +103,7 @@ class CanInjectorDriver : public FwObject,
         InjectState(CanInjectorDriver *parent, const char *name)
             : FwAttribute(name) , parent_(parent) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override {
             u_.u8 = parent_->getState();
         }
@@ -113,6 +116,7 @@ class CanInjectorDriver : public FwObject,
         BusUtilizationAttribute(CanInjectorDriver *parent, const char *name)
             : FwAttribute(name) , parent_(parent), busy_(0), total_(0) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override;
         virtual void setData(uint32_t busy, uint32_t total) {
             busy_ += busy;
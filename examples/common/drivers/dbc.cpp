@@ -15,9 +15,11 @@
  */
 
 #include <prjtypes.h>
+#include <string.h>
 #include <fwapi.h>
 #include <uart.h>
 #include <canframe.h>
+#include <fwtimer.h>
 #include "dbc.h"
 
 /**
@@ -25,8 +27,16 @@
  * @param[in] name Module name used as the string identificator
  */
 DbcConverter::DbcConverter(const char *name) : FwObject(name),
-    tmpRx_("trx") {
+    tmpRx_("trx"),
+    candrop_("candrop"),
+    wrdrop_("wrdrop") {
     erawstate_ = State_PRM1;
+    candrop_.make_uint32(0);
+    wrdrop_.make_uint32(0);
+    for (int i = 0; i < DBC_CAN_BUSES; i++) {
+        ican_[i] = 0;
+    }
+    fw_ring_init(&canring_, sizeof(can_frame_type), DBC_CAN_REQUESTS_MAX);
 }
 
 /**
@@ -34,12 +44,16 @@ DbcConverter::DbcConverter(const char *name) : FwObject(name),
  */
 void DbcConverter::Init() {
     RegisterInterface(static_cast<RawListenerInterface *>(this));
+    RegisterInterface(static_cast<CanListenerInterface *>(this));
+    RegisterInterface(static_cast<TimerListenerInterface *>(this));
+
+    RegisterAttribute(&candrop_);
+    RegisterAttribute(&wrdrop_);
 }
 
 void DbcConverter::PostInit() {
 #ifdef SHOW_DBC
     FwObject *obj;
-    FwList *p;
     int obj_idx = 0;
     int start_bit = 0;
 
@@ -86,13 +100,9 @@ void DbcConverter::PostInit() {
                 0x80000000 | CAN_MSG_ID_DBG_OUTPT);  // extended format
 
 
-    p = fw_get_objects_list();
-    obj_idx = 0;
-    while (p) {
-        obj = reinterpret_cast<FwObject *>(fwlist_get_payload(p));
+    for (obj_idx = 0; obj_idx < fw_get_objects_count(); obj_idx++) {
+        obj = reinterpret_cast<FwObject *>(fw_get_obj_by_index(obj_idx));
         printDbcObject(obj_idx, obj, "GARDEMARIN");
-        p = p->next;
-        obj_idx++;
     }
     uart_printf("\r\n");
 
@@ -112,6 +122,38 @@ void DbcConverter::PostInit() {
     if (iraw) {
         iraw->RegisterRawListener(static_cast<RawListenerInterface *>(this));
     }
+
+    // The same requests are accepted from the CAN buses. One mask over the
+    // whole OBJ_MSG_ID() space takes a single filter bank and passes the
+    // objects created after PostInit() as well.
+    static const char *CAN_BUSES[DBC_CAN_BUSES] = {"can1", "can2"};
+    for (int i = 0; i < DBC_CAN_BUSES; i++) {
+        ican_[i] = reinterpret_cast<CanInterface *>(
+            fw_get_object_interface(CAN_BUSES[i], "CanInterface"));
+        if (ican_[i] == 0) {
+            continue;
+        }
+        ican_[i]->RegisterCanListener(static_cast<CanListenerInterface *>(this),
+                                      CAN_ID_EXT | CAN_DBC_REQUEST_ID,
+                                      CAN_ID_EXT | 0x1FFFFF00);
+    }
+}
+
+/**
+ * @brief Called in the deferred work task shared by all bottom halves, so
+ *        never blocks on the uart. Only this task writes candrop_.
+ */
+void DbcConverter::CanCallback(can_frame_type *frame) {
+    if (!fw_ring_write(&canring_, frame, 1)) {
+        candrop_.make_uint32(candrop_.to_uint32() + 1);
+    }
+}
+
+void DbcConverter::callbackTimer(uint64_t tickcnt) {
+    can_frame_type frame;
+    while (fw_ring_read(&canring_, &frame, 1)) {
+        processRxCanFrame(&frame);
+    }
 }
 
 /**
@@ -171,7 +213,7 @@ void DbcConverter::RawCallback(const char *buf, int sz) {
             if (++rawcnt_ == 2*rawdlc_) {
                 erawstate_ = State_PRM1;
                 can_frame_type frame;
-                frame.busid = 0;
+                frame.busid = DBC_BUS_UART;
                 frame.id = FwAttribute::str2hex32(rawid_, 8);
                 frame.dlc = static_cast<uint8_t>(rawdlc_);
                 for (uint8_t n = 0; n < frame.dlc; n++) {
@@ -270,11 +312,165 @@ void DbcConverter::ConvertDataToAttribute(const char *buf,
 
 
 /**
- * @brief CAN messages length
- * @todo find the longest message and use its size as DLC
+ * @brief CAN messages length: multiplexor and the longest page of the object
+ */
+int DbcConverter::GetCanMessageDlc(FwObject *obj, DbcPackLayout *layout) {
+    int bits = 0;
+    int t;
+    for (int i = 0; i < layout->pages; i++) {
+        if (bits < layout->pagebits[i]) {
+            bits = layout->pagebits[i];
+        }
+    }
+    for (int a = 0; a < layout->total; a++) {
+        t = singleMuxBits(obj, layout, a);
+        if (bits < t) {
+            bits = t;
+        }
+    }
+    return 1 + (bits + 7) / 8;
+}
+
+/**
+ * @brief Size of the numeric attribute that is not packed and described in
+ *        DBC on its single attribute mux, zero otherwise
  */
-int DbcConverter::GetCanMessageDlc() {
-    return 8;
+int DbcConverter::singleMuxBits(FwObject *obj, DbcPackLayout *layout, int a) {
+    FwAttribute *atr = obj->GetAttributeByIndex(a);
+    int bits = atr->BitSize();
+    if (layout->page[a] != DBC_PACK_NONE || a >= DBC_PACK_MUX
+        || atr->kind() < Attr_Int8 || atr->kind() > Attr_Double) {
+        return 0;
+    }
+    if (bits > DBC_PACK_PAYLOAD_BITS) {
+        bits = DBC_PACK_PAYLOAD_BITS;
+    }
+    return bits;
+}
+
+int DbcConverter::packLayout(FwObject *obj, DbcPackLayout *layout) {
+    uint8_t order[DBC_PACK_ATTR_MAX];
+    int total = obj->GetAttributesCount();
+    int bits;
+    int a;
+    int k;
+    int p;
+
+    if (total > DBC_PACK_ATTR_MAX) {
+        // Higher indexes are accessible only by the single attribute mux
+        total = DBC_PACK_ATTR_MAX;
+    }
+    layout->total = total;
+    layout->pages = 0;
+    for (a = 0; a < total; a++) {
+        // Zero size attribute stays on the single attribute mux
+        bits = 0;
+        if (obj->GetAttributeByIndex(a)->isPackable()) {
+            bits = obj->GetAttributeByIndex(a)->BitSize();
+        }
+        if (bits > DBC_PACK_PAYLOAD_BITS) {
+            bits = DBC_PACK_PAYLOAD_BITS;
+        }
+        layout->bitsz[a] = static_cast<uint8_t>(bits);
+        layout->page[a] = DBC_PACK_NONE;
+        layout->startbit[a] = 0;
+
+        // Stable insertion sort by decreasing size keeps natural alignment
+        for (k = a; k > 0 && layout->bitsz[order[k - 1]] < bits; k--) {
+            order[k] = order[k - 1];
+        }
+        order[k] = static_cast<uint8_t>(a);
+    }
+
+    for (k = 0; k < total; k++) {
+        a = order[k];
+        bits = layout->bitsz[a];
+        if (bits == 0) {
+            continue;
+        }
+        for (p = 0; p < layout->pages; p++) {
+            if (layout->pagebits[p] + bits <= DBC_PACK_PAYLOAD_BITS) {
+                break;
+            }
+        }
+        if (p == layout->pages) {
+            if (p == DBC_PACK_PAGES_MAX) {
+                continue;
+            }
+            layout->pagebits[layout->pages++] = 0;
+        }
+        layout->page[a] = static_cast<uint8_t>(p);
+        layout->startbit[a] = static_cast<uint8_t>(8 + layout->pagebits[p]);
+        layout->pagebits[p] += static_cast<uint8_t>(bits);
+    }
+    return layout->pages;
+}
+
+void DbcConverter::getPackedPage(DbcPackLayout *layout,
+                                 int page,
+                                 DbcPackPage *pg) {
+    pg->page = static_cast<uint8_t>(page);
+    pg->cnt = 0;
+    pg->bits = layout->pagebits[page];
+    for (int a = 0; a < layout->total; a++) {
+        if (layout->page[a] != page) {
+            continue;
+        }
+        pg->attr[pg->cnt] = static_cast<uint8_t>(a);
+        pg->startbit[pg->cnt] = layout->startbit[a];
+        pg->bitsz[pg->cnt] = layout->bitsz[a];
+        pg->cnt++;
+    }
+}
+
+void DbcConverter::encodePackedPage(int obj_idx,
+                                    FwObject *obj,
+                                    DbcPackPage *pg,
+                                    can_frame_type *frame) {
+    char tbuf[8];
+    FwAttribute *attr;
+
+    frame->id = CAN_ID_EXT | OBJ_MSG_ID(obj_idx);
+    frame->dlc = static_cast<uint8_t>(1 + pg->bits / 8);
+    memset(frame->data.u8, 0, sizeof(frame->data.u8));
+    frame->data.u8[0] = static_cast<uint8_t>(DBC_PACK_MUX | pg->page);
+    for (int i = 0; i < pg->cnt; i++) {
+        attr = obj->GetAttributeByIndex(pg->attr[i]);
+        // read() always outputs BitSize()/8 bytes
+        attr->read(tbuf, sizeof(tbuf));
+        memcpy(&frame->data.u8[pg->startbit[i] / 8], tbuf, pg->bitsz[i] / 8);
+    }
+}
+
+void DbcConverter::processPackedFrame(int obj_idx,
+                                      FwObject *obj,
+                                      int page,
+                                      int we,
+                                      can_frame_type *frame) {
+    DbcPackPage pg;
+    char tbuf[8];
+    int pos;
+    int sz;
+
+    if (page >= packLayout(obj, &layout_)) {
+        return;
+    }
+    if (!we) {
+        getPackedPage(&layout_, page, &pg);
+        encodePackedPage(obj_idx, obj, &pg, frame);
+        processTxCanFrame(frame);
+        return;
+    }
+
+    for (int a = 0; a < layout_.total; a++) {
+        pos = layout_.startbit[a] / 8;
+        sz = layout_.bitsz[a] / 8;
+        if (layout_.page[a] != page || pos + sz > frame->dlc) {
+            continue;
+        }
+        memcpy(tbuf, &frame->data.u8[pos], sz);
+        writeAttribute(obj, obj->GetAttributeByIndex(a), tbuf, sz);
+    }
 }
 
 void DbcConverter::processRxCanFrame(can_frame_type *frame) {
@@ -289,7 +485,9 @@ void DbcConverter::processRxCanFrame(can_frame_type *frame) {
     we = (frame->data.u8[0] >> 7) & 1;
 
     obj = reinterpret_cast<FwObject *>(fw_get_obj_by_index(obj_idx));
-    if (obj != 0) {
+    if (obj != 0 && (atr_idx & DBC_PACK_MUX)) {
+        processPackedFrame(obj_idx, obj, atr_idx & ~DBC_PACK_MUX, we, frame);
+    } else if (obj != 0) {
         attr = reinterpret_cast<FwAttribute *>(fw_get_obj_attr_by_index(obj, atr_idx));
         if (attr) {
             if (we) {
@@ -309,7 +507,7 @@ void DbcConverter::processRxCanFrame(can_frame_type *frame) {
                     frame->data.s8[2] = frame->data.s8[3];
                     frame->data.s8[3] = t1;
                 }
-                attr->write(&frame->data.s8[1], frame->dlc - 1, true);
+                writeAttribute(obj, attr, &frame->data.s8[1], frame->dlc - 1);
             } else {
 //                uart_printf("DBC read from %s::%s\r\n",
 //                            obj->ObjectName(),
@@ -323,14 +521,72 @@ void DbcConverter::processRxCanFrame(can_frame_type *frame) {
     }
 }
 
-// TODO: through the CAN interface
+static void dbc_write_attribute(void *ctx, char *data, int sz) {
+    // silence = true: do not send message was update
+    reinterpret_cast<FwAttribute *>(ctx)->write(data, sz, true);
+}
+
+/**
+ * @brief Attribute of the object with the timer listener is written in the
+ *        task of its execution class, not concurrently with the callbacks.
+ */
+void DbcConverter::writeAttribute(FwObject *obj,
+                                  FwAttribute *attr,
+                                  char *buf,
+                                  int sz) {
+    CommonInterface *iface = obj->GetInterface("TimerListenerInterface");
+    int cls;
+
+    if (iface == 0) {
+        dbc_write_attribute(attr, buf, sz);
+        return;
+    }
+    cls = static_cast<TimerListenerInterface *>(iface)->getExecClass();
+    if (!fw_timer_call(cls, dbc_write_attribute, attr, buf, sz)) {
+        // No free text in the DBC response stream
+        wrdrop_.make_uint32(wrdrop_.to_uint32() + 1);
+    }
+}
+
+/**
+ * @brief Response is sent to the bus of the request. Silent bus does not
+ *        accept frames, then the response is printed into the uart.
+ */
 void DbcConverter::processTxCanFrame(can_frame_type *frame) {
+    char buf[DBC_TX_LINE_MAX];
+    if (frame->busid < DBC_CAN_BUSES && ican_[frame->busid]) {
+        frame->data.u8[0] &= 0x7F;
+        if (ican_[frame->busid]->WriteCanFrame(frame)) {
+            return;
+        }
+    }
+    formatTxCanFrame(frame, buf);
+    uart_printf("%s", buf);
+}
+
+int DbcConverter::formatTxCanFrame(can_frame_type *frame, char *buf) {
+    static const char HEX[] = "0123456789abcdef";
+    int pos = 0;
+
+    uint32_t id = frame->id & ~CAN_ID_EXT;
+
     frame->data.u8[0] &= 0x7F;  //
-    uart_printf("<!%08x,%d,", frame->id, frame->dlc);
+    buf[pos++] = '<';
+    buf[pos++] = '!';
+    for (int i = 28; i >= 0; i -= 4) {
+        buf[pos++] = HEX[(id >> i) & 0xF];
+    }
+    buf[pos++] = ',';
+    buf[pos++] = static_cast<char>('0' + frame->dlc);
+    buf[pos++] = ',';
     for (uint8_t i = 0; i < frame->dlc; i++) {
-        uart_printf("%02x", frame->data.u8[i]);
+        buf[pos++] = HEX[frame->data.u8[i] >> 4];
+        buf[pos++] = HEX[frame->data.u8[i] & 0xF];
     }
-    uart_printf("%s", "\r\n");
+    buf[pos++] = '\r';
+    buf[pos++] = '\n';
+    buf[pos] = '\0';
+    return pos;
 }
 
 /**
@@ -338,11 +594,10 @@ void DbcConverter::processTxCanFrame(can_frame_type *frame) {
  */
 int DbcConverter::printDbcAttribute(int mux_idx,
                                     int start_bit,
+                                    int bit_sz,
                                     const char *objname,
                                     FwAttribute *atr,
                                     const char *dstname) {
-
-    int bit_sz = atr->BitSize();
     uart_printf(" SG_ %s_%s", objname, atr->name());
 
     if (mux_idx != -1) {
@@ -365,66 +620,49 @@ int DbcConverter::printDbcAttribute(int mux_idx,
 }
 
 /**
- * @brief Print SG_ lines for a specific object into DBG output
- *
- * @warning Do not increment start_bit for now, transmit attribtues in a
- *          separate messages without packing (maybe changed in future)
+ * @brief Print SG_ lines for a specific object into DBG output using
+ *        the packed layout of the attributes
  */
 void DbcConverter::printDbcObject(int obj_idx,
                                  FwObject *obj,
                                  const char *dstname) {
-    int atr_idx = 0;
-    int start_bit = 0;
-    int mux_idx = -1;
-    int bits_total = 0;
-    FwList *atrlist = obj->GetAttributes();
     FwAttribute *atr;
+    int bits;
 
-    while (atrlist) {
-        atr = reinterpret_cast<FwAttribute *>(fwlist_get_payload(atrlist));
-        if (bits_total < atr->BitSize()) {
-             bits_total = atr->BitSize();
-        }
-        atr_idx++;
-        atrlist = atrlist->next;
-    }
-    if (atr_idx > 1) {
-        bits_total += 8;
-        start_bit = 8;
-        mux_idx = 0;
-    }
+    packLayout(obj, &layout_);
 
     uart_printf("BO_ %u %s: %d GARDEMARIN\r\n",
-                0x80000000 | (OBJ_MSG_ID(obj_idx)),
+                CAN_ID_EXT | OBJ_MSG_ID(obj_idx),
                 obj->ObjectName(),
-                (bits_total + 7) / 8);
+                GetCanMessageDlc(obj, &layout_));
 
 
-    // Use multiplexer [7:0] to access attributes:
-    if (atr_idx > 1) {
-        uart_printf(" SG_ %s_mux M", obj->ObjectName());
-
-        // @1+    = little-endian, unsigned. Don't change it
-        // (1,0)  = (scale,offset)
-        // [0,0]  = (min,max)
-        // \"\"   = units
-        uart_printf(" : 0|8d@1+ (1,0) [0|0] \"\" %s\r\n", dstname);
-    }
+    // Use multiplexer [7:0] to access pages of attributes:
+    uart_printf(" SG_ %s_mux M", obj->ObjectName());
 
-    atrlist = obj->GetAttributes();
-    while (atrlist) {
-        atr = reinterpret_cast<FwAttribute *>(fwlist_get_payload(atrlist));
-
-        start_bit = printDbcAttribute(mux_idx,
-                                      start_bit,
-                                      obj->ObjectName(),
-                                      atr,
-                                      dstname);
-        atrlist = atrlist->next;
-        if (mux_idx != -1) {
-            start_bit = 8;
-            mux_idx++;
+    // @1+    = little-endian, unsigned. Don't change it
+    // (1,0)  = (scale,offset)
+    // [0,0]  = (min,max)
+    // \"\"   = units
+    uart_printf(" : 0|8@1+ (1,0) [0|0] \"\" %s\r\n", dstname);
+
+    for (int atr_idx = 0; atr_idx < layout_.total; atr_idx++) {
+        atr = obj->GetAttributeByIndex(atr_idx);
+        if (layout_.page[atr_idx] == DBC_PACK_NONE) {
+            // Numeric attribute with hooks is on the single attribute mux
+            bits = singleMuxBits(obj, &layout_, atr_idx);
+            if (bits) {
+                printDbcAttribute(atr_idx, 8, bits, obj->ObjectName(), atr,
+                                  dstname);
+            }
+            continue;
         }
+        printDbcAttribute(DBC_PACK_MUX | layout_.page[atr_idx],
+                          layout_.startbit[atr_idx],
+                          layout_.bitsz[atr_idx],
+                          obj->ObjectName(),
+                          atr,
+                          dstname);
     }
     uart_printf("\r\n");
 }
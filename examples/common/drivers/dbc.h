@@ -21,10 +21,58 @@
 #include <FwAttribute.h>
 #include <RawInterface.h>
 #include <CanInterface.h>
+#include <TimerInterface.h>
+#include <fwring.h>
+
+/**
+ * @brief Attributes of one object are bin-packed into the multiplexed
+ *        messages (pages). Payload byte [0] is the multiplexor:
+ *          [7]   write enable
+ *          [6]   1 = page index, 0 = single attribute index (legacy)
+ *          [5:0] page or attribute index
+ *        Bytes [7:1] store the attributes of the page in little-endian
+ *        order. 64-bits attributes are clipped to 56 bits.
+ */
+static const int DBC_PACK_ATTR_MAX = 64;
+static const int DBC_PACK_PAGES_MAX = 64;
+static const int DBC_PACK_PAYLOAD_BITS = 56;
+static const uint8_t DBC_PACK_MUX = 0x40;
+static const uint8_t DBC_PACK_NONE = 0xFF;
+/** can_frame_type::busid of the requests received through the uart */
+static const uint8_t DBC_BUS_UART = 0xFF;
+/** CAN buses "can1", "can2" in the order of their busid */
+static const int DBC_CAN_BUSES = 2;
+
+typedef struct DbcPackLayout {
+    int total;                              // number of packed attributes
+    int pages;                              // number of used pages
+    uint8_t page[DBC_PACK_ATTR_MAX];        // page of the attribute
+    uint8_t startbit[DBC_PACK_ATTR_MAX];    // including multiplexor byte
+    uint8_t bitsz[DBC_PACK_ATTR_MAX];
+    uint8_t pagebits[DBC_PACK_PAGES_MAX];   // used payload bits of the page
+} DbcPackLayout;
+
+/** Every attribute takes at least one byte of the 7 bytes payload */
+static const int DBC_PACK_PAGE_ATTR_MAX = DBC_PACK_PAYLOAD_BITS / 8;
+
+/**
+ * @brief Attributes of one page extracted from DbcPackLayout, small enough
+ *        to be cached by the periodic output
+ */
+typedef struct DbcPackPage {
+    uint8_t page;
+    uint8_t cnt;
+    uint8_t bits;                               // used payload bits
+    uint8_t attr[DBC_PACK_PAGE_ATTR_MAX];       // attribute indexes
+    uint8_t startbit[DBC_PACK_PAGE_ATTR_MAX];
+    uint8_t bitsz[DBC_PACK_PAGE_ATTR_MAX];
+} DbcPackPage;
 
 // CAN Data Base Converter
 class DbcConverter : public FwObject,
-                     public RawListenerInterface {
+                     public RawListenerInterface,
+                     public CanListenerInterface,
+                     public TimerListenerInterface {
  public:
     explicit DbcConverter(const char *name);
 
@@ -35,27 +83,83 @@ class DbcConverter : public FwObject,
     // RawListenerInterface
     virtual void RawCallback(const char *buf, int sz) override;
 
+    // CanListenerInterface: called from the CAN dispatch work
+    virtual void CanCallback(can_frame_type *frame) override;
+
+    // TimerListenerInterface: requests are processed in the same task as
+    // the uart input, so that layout_ and the parser state are not shared
+    virtual uint64_t getTimerInterval() override { return 10; }
+    virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_COMMS; }
+
+    /**
+     * @brief Format CAN frame as the text line "<!IIIIIIII,D,payload\r\n"
+     * @param[in] frame CAN frame with the read response
+     * @param[out] buf Output buffer of DBC_TX_LINE_MAX bytes at least
+     * @return Number of characters written into buffer without trailing zero
+     */
+    static int formatTxCanFrame(can_frame_type *frame, char *buf);
+
+    static const int DBC_TX_LINE_MAX = 40;
+
+    /**
+     * @brief Pack attributes of the object into as few pages as possible
+     *        using first-fit decreasing by BitSize(). The result depends
+     *        only on the attributes list, so it is the same in the DBC
+     *        output and in the encode/decode paths. Attributes that are
+     *        not FwAttribute::isPackable() get no page.
+     * @param[in] obj Object to pack
+     * @param[out] layout Attributes placement
+     * @return Number of pages
+     */
+    static int packLayout(FwObject *obj, DbcPackLayout *layout);
+
+    /**
+     * @brief Extract attributes of the page from the object layout
+     * @param[in] layout Layout computed by packLayout()
+     * @param[in] page Page index
+     * @param[out] pg Page descriptor
+     */
+    static void getPackedPage(DbcPackLayout *layout, int page, DbcPackPage *pg);
+
+    /**
+     * @brief Form read response with all attributes of the page
+     * @param[in] obj_idx Object index used in CAN ID
+     * @param[in] obj Object pointer
+     * @param[in] pg Page descriptor from getPackedPage()
+     * @param[out] frame Output CAN frame
+     */
+    static void encodePackedPage(int obj_idx,
+                                 FwObject *obj,
+                                 DbcPackPage *pg,
+                                 can_frame_type *frame);
 
  private:
-    int GetCanMessageDlc();
+    int GetCanMessageDlc(FwObject *obj, DbcPackLayout *layout);
+    static int singleMuxBits(FwObject *obj, DbcPackLayout *layout, int a);
 
     void processRxCanFrame(can_frame_type *frame);
     void processTxCanFrame(can_frame_type *frame);
+    void writeAttribute(FwObject *obj, FwAttribute *attr, char *buf, int sz);
+    void processPackedFrame(int obj_idx,
+                            FwObject *obj,
+                            int page,
+                            int we,
+                            can_frame_type *frame);
 
     /**
      * @brief Print SG_ lines for a attribute of the object into DBG output
      */
     int printDbcAttribute(int mux_idx,
                          int start_bit,
+                         int bit_sz,
                          const char *objname,
                          FwAttribute *atr,
                          const char *dstname);
 
     /**
-     * @brief Print SG_ lines for a specific object into DBG output
-     *
-     * @warning Do not increment start_bit for now, transmit attribtues in a
-     *          separate messages without packing (maybe changed in future)
+     * @brief Print SG_ lines for a specific object into DBG output using
+     *        the packed layout of the attributes
      */
     void printDbcObject(int obj_idx,
                         FwObject *obj,
@@ -76,6 +180,12 @@ class DbcConverter : public FwObject,
     /** Temporary attribute to convert CAN message into modify request. No need
       * to register it in attribute list */
     FwAttribute tmpRx_;
+    FwAttribute candrop_;       // CAN requests dropped on full canring_
+    FwAttribute wrdrop_;        // writes dropped on full timer call queue
+    DbcPackLayout layout_;      // not on stack of the caller task
+    static const int DBC_CAN_REQUESTS_MAX = 8;
+    CanInterface *ican_[DBC_CAN_BUSES];
+    FwRing canring_;            // CAN dispatch work -> comms task
     enum ERawState {
         State_PRM1,     // 1 B = ">"
         State_PRM2,     // 1 B = "!"
@@ -17,25 +17,27 @@
 #include <prjtypes.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwirq.h>
+#include <fwwait.h>
+#include <fwclock.h>
 #include <new>
 #include <string.h>
 #include <uart.h>
 #include "display_spi.h"
 
 
-IrqHandlerInterface *drv_display_spi_tx_ = 0;
 volatile char timeout_flag_ = 0;
 
 
 DisplaySPI::DisplaySPI(const char *name) : FwObject(name) {
     estate_ = Idle;
     bitCnt_ = 0;
-    drv_display_spi_tx_ = static_cast<IrqHandlerInterface *>(this);
 }
 
 void DisplaySPI::Init() {
     RegisterInterface(static_cast<IrqHandlerInterface *>(this));
     RegisterInterface(static_cast<DisplayInterface *>(this));
+    fw_irq_bind(51, static_cast<IrqHandlerInterface *>(this));   // SPI3
 }
 
 static void init_systick() {
@@ -63,13 +65,13 @@ void DisplaySPI::PostInit() {
 
     uart_printk("LCD: resetting...\r\n");
     gpio_pin_clear(&DISPLAY_RES);   // reset: active LOW
-    system_delay_ns(20000000);         // > 10 us
+    fw_wait_delay_us(20000);        // > 10 us
     gpio_pin_set(&DISPLAY_RES);   // reset: active LOW
     uart_printk("LCD: reset done\r\n");
 
     // Sleep out command (DC=0)
     write_cmd_poll(0x11);           // 0x11 sleep-out command
-    system_delay_ns(125000000);     // > 120 ms
+    fw_wait_delay_us(125000);       // > 120 ms
     uart_printk("LCD: sleep out done\r\n");
 
     // Idle mode off command (DC=0)
@@ -359,25 +361,39 @@ void DisplaySPI::starCounter(void *dev, int usec) {
 }
 
 
+// SR[1] TXE: transmit buffer empty: 0=not empty; 1=empty
+// SR[7] BSY: Busy flag: 1 Tx buffer is not empty
+//
+// Data bytes are only queued into the Tx buffer (one byte time of wait
+// at most). The shifter is drained (BSY=0) only when DC line should
+// switch, so the bursts of pixel data go back-to-back.
+// One byte time is too short to yield the CPU, but the spin is accounted
+// in the busy wait time when the flag is not ready immediately.
+static void spi_wait_sr(SPI_registers_type *spi, uint16_t mask, uint16_t val) {
+    uint64_t t0;
+    if ((read16(&spi->SR) & mask) == val) {
+        return;
+    }
+    t0 = fw_clock_get_us();
+    while ((read16(&spi->SR) & mask) != val) {}
+    fw_wait_account(t0);
+}
+
 void DisplaySPI::write_cmd_poll(uint16_t cmd) {
     SPI_registers_type *SPI3 = spi_bar();
+    spi_wait_sr(SPI3, 0x2, 0x2);        // TXE = 1
+    spi_wait_sr(SPI3, 0x80, 0);         // BSY = 0
     gpio_pin_clear(&DISPLAY_DC);    // 0=CMD
     write16(&SPI3->DR, cmd);
-    // SR[1] TXE: transmit buffer empty: 0=not empty; 1=empty
-    // SR[7] BSY: Busy flag: 1 Tx buffer is not empty
-    while ((read16(&SPI3->SR) & 0x2) == 0) {}
-    while ((read16(&SPI3->SR) & 0x80)) {}
+    spi_wait_sr(SPI3, 0x2, 0x2);
+    spi_wait_sr(SPI3, 0x80, 0);
     gpio_pin_set(&DISPLAY_DC);    // 1=DATA
 }
 
 void DisplaySPI::write_data_poll(uint16_t data) {
     SPI_registers_type *SPI3 = spi_bar();
-    gpio_pin_set(&DISPLAY_DC);      // 1=DATA
+    spi_wait_sr(SPI3, 0x2, 0x2);
     write16(&SPI3->DR, data);
-    // SR[1] TXE: transmit buffer empty: 0=not empty; 1=empty
-    // SR[7] BSY: Busy flag: 1 Tx buffer is not empty
-    while ((read16(&SPI3->SR) & 0x2) == 0) {}
-    while ((read16(&SPI3->SR) & 0x80)) {}
 }
 
 
@@ -17,6 +17,8 @@
 #include <prjtypes.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwirq.h>
+#include <fwlat.h>
 #include "ds18b20_drv.h"
 #include <uart.h>
 
@@ -27,8 +29,6 @@ static const gpio_pin_type GPIO_CFG[GARDEMARIN_DS18B20_TOTAL] = {
     {(GPIO_registers_type *)GPIOA_BASE, 11}
 };
 
-static IrqHandlerInterface *drivers_ = 0;
-
 static void startCounter(TIM_registers_type *TIM, int usec) {
     tim_cr1_reg_type cr1;
 
@@ -39,15 +39,22 @@ static void startCounter(TIM_registers_type *TIM, int usec) {
     cr1.bits.CEN = 1;
     cr1.bits.OPM = 1;   // one pulse mode
     cr1.bits.DIR = 1;   // downcount
+    fw_lat_arm(29, TIM, static_cast<uint32_t>(usec));
     write32(&TIM->CR1.val, cr1.val);
 }
 
 // Configure TIM3 as a 15 us interval former
 extern "C" void TIM3_irq_handler() {
     TIM_registers_type *TIM3 = (TIM_registers_type *)TIM3_BASE;
+    fw_lat_isr_entry(29);
 
     int usec = 0;
-    drivers_->handleInterrupt(&usec);
+    // [0] UIF update interrupt flag
+    if ((read16(&TIM3->SR) & 0x1) == 0) {
+        fw_irq_spurious(29);
+    } else {
+        fw_irq_dispatch(29, &usec);
+    }
 
     write16(&TIM3->SR, 0);  // clear all pending bits
     nvic_irq_clear(29);
@@ -81,7 +88,6 @@ Ds18b20Driver::Ds18b20Driver(const char *name)
 
     RCC_registers_type *RCC = (RCC_registers_type *)RCC_BASE;
     TIM_registers_type *TIM3 = (TIM_registers_type *)TIM3_BASE;
-    drivers_ = static_cast<IrqHandlerInterface *>(this);
 
     for (int i = 0; i < GARDEMARIN_DS18B20_TOTAL; i++) {
         gpio_pin_as_output(&GPIO_CFG[i],
@@ -114,6 +120,7 @@ void Ds18b20Driver::Init() {
 
     RegisterInterface(static_cast<IrqHandlerInterface *>(this));
     RegisterInterface(static_cast<TimerListenerInterface *>(this));
+    fw_irq_bind(29, static_cast<IrqHandlerInterface *>(this));
 }
 
 void Ds18b20Driver::callbackTimer(uint64_t tickcnt) {
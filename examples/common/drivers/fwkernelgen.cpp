@@ -15,10 +15,36 @@
  */
 
 #include <fwapi.h>
+#include <fwirq.h>
+#include <fwlat.h>
+#include <fwwork.h>
+#include <fwclock.h>
+#include <fwwait.h>
+#include <fwtimer.h>
+#include <FreeRTOS.h>
 #include <uart.h>
 #include "fwkernelgen.h"
 #include <string.h>
 
+FW_STATIC_TABLE_BEGIN
+const FwStaticEntry KernelClassGeneric::ATTRIBUTES[] = {
+    FW_STATIC_ENTRY(KernelClassGeneric, targetConfig_, "TargetConfig"),
+    FW_STATIC_ENTRY(KernelClassGeneric, version_, "Version"),
+    FW_STATIC_ENTRY(KernelClassGeneric, output_, "Output"),
+    FW_STATIC_ENTRY(KernelClassGeneric, irqUnbound_, "IrqUnbound"),
+    FW_STATIC_ENTRY(KernelClassGeneric, irqSpurious_, "IrqSpurious"),
+    FW_STATIC_ENTRY(KernelClassGeneric, irqStat_, "IrqStat"),
+    FW_STATIC_ENTRY(KernelClassGeneric, workStat_, "WorkStat"),
+    FW_STATIC_ENTRY(KernelClassGeneric, clockUs_, "ClockUs"),
+    FW_STATIC_ENTRY(KernelClassGeneric, clockHi_, "ClockHi"),
+    FW_STATIC_ENTRY(KernelClassGeneric, busyWaitUs_, "BusyWaitUs"),
+    FW_STATIC_ENTRY(KernelClassGeneric, waitTimeouts_, "WaitTimeouts"),
+    FW_STATIC_ENTRY(KernelClassGeneric, execStat_, "ExecStat"),
+    FW_STATIC_ENTRY(KernelClassGeneric, outputDeadband_, "OutputDeadband"),
+    FW_STATIC_ENTRY(KernelClassGeneric, outputDrops_, "OutputDrops")
+};
+FW_STATIC_TABLE_END
+
 /**
  * @brief Kernel module constructor. Instance of this KernelClass registered
  *        as the first element in the single linked list of FwObjects.
@@ -27,19 +53,33 @@ KernelClassGeneric::KernelClassGeneric(const char *name) : FwObject(name),
     targetConfig_(this, "TargetConfig"),
     version_("Version"),
     output_(this, "Output"),
-    dbc_("dbc")
+    irqUnbound_("IrqUnbound", "Interrupts without bound handler", false),
+    irqSpurious_("IrqSpurious", "Interrupts without pending event", true),
+    irqStat_("IrqStat"),
+    workStat_("WorkStat"),
+    clockUs_("ClockUs", "[us] monotonic clock [31:0], latches [63:32]", 0),
+    clockHi_("ClockHi", "[us] monotonic clock [63:32] latched by ClockUs",
+             &clockUs_),
+    busyWaitUs_("BusyWaitUs", "[us] time spent in spinning waits", false),
+    waitTimeouts_("WaitTimeouts", "Hardware waits ended by timeout", true),
+    execStat_("ExecStat"),
+    outputDeadband_("OutputDeadband", "On change Output: minimal absolute "
+                    "change of the value, 0=any change. Write before Output"),
+    outputDrops_("OutputDrops", "Output enables dropped, list is full")
+    KERNEL_GENERIC_OBJECTS(FW_STATIC_INIT)
 {
     version_.make_uint32(0x20240804);
     output_.make_int32(0);
+    outputDeadband_.make_float(0);
+    outputDrops_.make_uint32(0);
+    SetStaticAttributes(ATTRIBUTES, FW_STATIC_TABLE_SIZE(ATTRIBUTES));
 }
 
 /**
- * @brief Overrided FwObject method to register attribtues and interface
+ * @brief Overrided FwObject method to register attribtues and interface.
+ *        Kernel attributes are described by the static table.
  */
 void KernelClassGeneric::Init() {
-    RegisterAttribute(&targetConfig_);
-    RegisterAttribute(&version_);
-    RegisterAttribute(&output_);
 }
 
 /**
@@ -47,62 +87,91 @@ void KernelClassGeneric::Init() {
  */
 void KernelClassGeneric::PostInit() {
     targetConfig_.to_string();
+    telemetry_.start();
 }
 
-void KernelClassGeneric::addToOutputList(FwAttribute *attr, uint32_t period) {
-    
+bool KernelClassGeneric::addToOutputList(int objid,
+                                         int attrid,
+                                         FwAttribute *attr,
+                                         uint32_t period,
+                                         float deadband) {
+    return telemetry_.add(objid, attrid, attr, period, deadband);
 }
 
 void KernelClassGeneric::removeFromOutputList(FwAttribute *attr) {
+    telemetry_.remove(attr);
 }
 
 
 void KernelClassGeneric::TargetConfigAttribute::pre_read() {
-FwObject *obj;
+    FwObject *obj;
     FwAttribute *attr;
-    FwList *p = fw_get_objects_list();
-    FwList *alist;
+    int obj_total = fw_get_objects_count();
+    int atr_total;
     int obj_idx;
     int atr_idx;
 
     uart_printk("'TargetConfig':{\r\n"
                 "    'ObjectsList':[\r\n");
-    obj_idx = 0;
-    while (p) {
-        obj = static_cast<FwObject *>(fwlist_get_payload(p));
+    for (obj_idx = 0; obj_idx < obj_total; obj_idx++) {
+        obj = reinterpret_cast<FwObject *>(fw_get_obj_by_index(obj_idx));
         uart_printk("       {'Index':%d, 'Name':'%s',\r\n",
                     obj_idx, obj->ObjectName());
         uart_printk("        'Attributes':[");
-        alist = obj->GetAttributes();
-        atr_idx = 0;
-        if (alist) {
+        atr_total = obj->GetAttributesCount();
+        if (atr_total) {
             uart_printk("\r\n");
         } else {
             uart_printk("]\r\n");
         }
-        while (alist) {
-            attr = (FwAttribute *)fwlist_get_payload(alist);
+        for (atr_idx = 0; atr_idx < atr_total; atr_idx++) {
+            attr = obj->GetAttributeByIndex(atr_idx);
             print_attribute(atr_idx, attr);
 
-            alist = alist->next;
-            if (alist) {
+            if (atr_idx + 1 < atr_total) {
                 uart_printk(",\r\n");
             } else {
                 uart_printk("]\r\n");
             }
-            atr_idx++;
         }
-        p = p->next;
-        if (p) {
+        if (obj_idx + 1 < obj_total) {
             uart_printk("       },\r\n");
         } else {
-            uart_printk("   }]\r\n");
+            uart_printk("   }],\r\n");
         }
-        obj_idx++;
     }
+    print_latency();
     uart_printk("}\r\n");
 }
 
+/**
+ * @brief Timer interrupt latency histograms (fwlat.c) in CPU clocks,
+ *        bucket k is the range [2^k, 2^(k+1)).
+ */
+void KernelClassGeneric::TargetConfigAttribute::print_latency() {
+    FwLatStat *p;
+    int cnt = 0;
+
+    uart_printk("    'CpuHz':%ld,\r\n", static_cast<int32_t>(SystemCoreClock));
+    uart_printk("    'IrqLatency':[");
+    for (int i = 0; i < FWLAT_SLOTS_MAX; i++) {
+        p = fw_lat_get_stat(i);
+        if (p->irqidx < 0) {
+            continue;
+        }
+        if (cnt++) {
+            uart_printk(",");
+        }
+        uart_printk("\r\n       {'Irq':%d, 'Max':%ld, 'Hist':[",
+                    p->irqidx, static_cast<int32_t>(p->max));
+        for (int n = 0; n < FWLAT_BUCKETS; n++) {
+            uart_printk(n ? ",%ld" : "%ld", static_cast<int32_t>(p->hist[n]));
+        }
+        uart_printk("]}");
+    }
+    uart_printk("]\r\n");
+}
+
 void KernelClassGeneric::TargetConfigAttribute::print_attribute(int idx,
                                                                 FwAttribute *attr) {
     int t1;
@@ -110,6 +179,7 @@ void KernelClassGeneric::TargetConfigAttribute::print_attribute(int idx,
     uart_printk("           {'Index':%d", idx);
     uart_printk(", 'Name':'%s'", attr->name());
     uart_printk(", 'Type':'%s'", KindTypeString[attr->kind()]);
+    uart_printk(", 'Pack':%d", attr->isPackable() ? 1 : 0);
     uart_printk(", 'Value':", KindTypeString[attr->kind()]);
     switch (attr->kind()) {
     case Attr_String:
@@ -180,10 +250,84 @@ void KernelClassGeneric::OutputControlAttribute::post_write() {
     }
 
     if (ctrl.b.ena_dis) {
-        parent_->addToOutputList(attr, ctrl.b.period);
+        if (!parent_->addToOutputList(ctrl.b.objid, ctrl.b.attrid,
+                                      attr, ctrl.b.period,
+                                      parent_->outputDeadband_.to_float())) {
+            parent_->outputDrops_.make_uint32(
+                    parent_->outputDrops_.to_uint32() + 1);
+        }
     } else {
         parent_->removeFromOutputList(attr);
     }
 
 }
 
+void KernelClassGeneric::IrqCounterAttribute::pre_read() {
+    if (spurious_) {
+        u_.u32 = fw_irq_get_spurious_total();
+    } else {
+        u_.u32 = fw_irq_get_unbound_total();
+    }
+}
+
+void KernelClassGeneric::IrqStatAttribute::post_write() {
+    irqidx_ = static_cast<int>(u_.u32 & 0xFF);
+}
+
+void KernelClassGeneric::IrqStatAttribute::pre_read() {
+    uint32_t unbound = fw_irq_get_unbound(irqidx_);
+    uint32_t spurious = fw_irq_get_spurious(irqidx_);
+    if (unbound > 0xFFFF) {
+        unbound = 0xFFFF;
+    }
+    if (spurious > 0xFFFF) {
+        spurious = 0xFFFF;
+    }
+    u_.u32 = (spurious << 16) | unbound;
+}
+
+void KernelClassGeneric::WorkStatAttribute::post_write() {
+    qidx_ = static_cast<int>(u_.u32 & 0xFF);
+}
+
+void KernelClassGeneric::WorkStatAttribute::pre_read() {
+    FwWorkQueue *q = fw_work_get_queue(qidx_);
+    uint32_t overrun;
+    if (q == 0) {
+        u_.u32 = 0;
+        return;
+    }
+    overrun = q->overrun;
+    if (overrun > 0xFFFF) {
+        overrun = 0xFFFF;
+    }
+    u_.u32 = (overrun << 16)
+           | ((q->maxdepth & 0xFF) << 8)
+           | (fw_work_get_depth(q) & 0xFF);
+}
+
+void KernelClassGeneric::ClockAttribute::pre_read() {
+    if (low_) {
+        u_.u32 = static_cast<uint32_t>(low_->latched_ >> 32);
+        return;
+    }
+    latched_ = fw_clock_get_us();
+    u_.u32 = static_cast<uint32_t>(latched_);
+}
+
+void KernelClassGeneric::WaitCounterAttribute::pre_read() {
+    if (timeouts_) {
+        u_.u32 = fw_wait_get_timeouts();
+    } else {
+        u_.u32 = fw_wait_get_busy_us();
+    }
+}
+
+void KernelClassGeneric::ExecStatAttribute::post_write() {
+    cls_ = static_cast<int>(u_.u32 & 0xFF);
+}
+
+void KernelClassGeneric::ExecStatAttribute::pre_read() {
+    FwTimerService *s = fw_timer_get_service(cls_);
+    u_.u32 = s ? s->wcrt_us : 0;
+}
@@ -22,6 +22,14 @@
 #include <uart_drv.h>
 #include "rtc_drv.h"
 #include "dbc.h"
+#include "telemetry.h"
+
+/**
+ * @brief Objects of the generic kernel, they get the first DBC indexes
+ *        after the kernel itself. See FW_STATIC_MEMBER() for the format.
+ */
+#define KERNEL_GENERIC_OBJECTS(X) \
+    X(DbcConverter, dbc_, "dbc")
 
 class KernelClassGeneric : public FwObject {
  public:
@@ -32,7 +40,8 @@ class KernelClassGeneric : public FwObject {
     virtual void PostInit() override;
 
  protected:
-    void addToOutputList(FwAttribute *attr, uint32_t period);
+    bool addToOutputList(int objid, int attrid, FwAttribute *attr,
+                         uint32_t period, float deadband);
     void removeFromOutputList(FwAttribute *attr);
 
  protected:
@@ -43,9 +52,11 @@ class KernelClassGeneric : public FwObject {
             make_string("");
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override;
      protected:
         void print_attribute(int idx, FwAttribute *attr);
+        void print_latency();
      private:
         KernelClassGeneric *parent_;
     };
@@ -56,9 +67,12 @@ class KernelClassGeneric : public FwObject {
     class OutputControlAttribute : public FwAttribute {
      public:
         OutputControlAttribute(KernelClassGeneric *parent, const char *name)
-            : FwAttribute(name, "Ena/dis periodic value output"), parent_(parent) {
+            : FwAttribute(name, "Ena/dis periodic value output: "
+                "[7:0] objid, [14:8] attrid, [15] ena, "
+                "[31:16] period ms, 0=on change"), parent_(parent) {
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void post_write() override;
 
         union ValueType {
@@ -75,11 +89,135 @@ class KernelClassGeneric : public FwObject {
         KernelClassGeneric *parent_;
     };
 
+    /**
+        Interrupt counters of the static vector table (fwirq.h)
+     */
+    class IrqCounterAttribute : public FwAttribute {
+     public:
+        IrqCounterAttribute(const char *name, const char *descr, bool spurious)
+            : FwAttribute(name, descr), spurious_(spurious) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+
+     private:
+        bool spurious_;
+    };
+
+    class IrqStatAttribute : public FwAttribute {
+     public:
+        IrqStatAttribute(const char *name)
+            : FwAttribute(name, "Write NVIC index, read counters: "
+                "[15:0] unbound, [31:16] spurious"), irqidx_(0) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+        virtual void post_write() override;
+
+     private:
+        int irqidx_;
+    };
+
+    /**
+        Deferred work queue statistic (fwwork.h)
+     */
+    class WorkStatAttribute : public FwAttribute {
+     public:
+        WorkStatAttribute(const char *name)
+            : FwAttribute(name, "Write queue index, read: [7:0] depth, "
+                "[15:8] max depth, [31:16] overrun"), qidx_(0) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+        virtual void post_write() override;
+
+     private:
+        int qidx_;
+    };
+
+    /**
+        Host clock synchronization: reading ClockUs latches 64-bit time
+        fw_clock_get_us() and returns its lower word, ClockHi returns the
+        upper word of the latched value.
+     */
+    class ClockAttribute : public FwAttribute {
+     public:
+        ClockAttribute(const char *name, const char *descr,
+                       ClockAttribute *low)
+            : FwAttribute(name, descr), low_(low), latched_(0) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+
+     private:
+        ClockAttribute *low_;       // zero for the lower word attribute
+        uint64_t latched_;
+    };
+
+    /**
+        Busy-wait statistic of the drivers (fwwait.h)
+     */
+    class WaitCounterAttribute : public FwAttribute {
+     public:
+        WaitCounterAttribute(const char *name, const char *descr, bool timeouts)
+            : FwAttribute(name, descr), timeouts_(timeouts) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+
+     private:
+        bool timeouts_;
+    };
+
+    /**
+        Timer service statistic per execution class (fwtimer.h)
+     */
+    class ExecStatAttribute : public FwAttribute {
+     public:
+        ExecStatAttribute(const char *name)
+            : FwAttribute(name, "Write execution class, read: "
+                "[us] worst case response time"), cls_(0) {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+        virtual void post_write() override;
+
+     private:
+        int cls_;
+    };
+
  protected:
     /** @brief Kernel Version attribute */
     TargetConfigAttribute targetConfig_;
     FwAttribute version_;
     OutputControlAttribute output_;    // enable/disable specific attribute periodic output
+    IrqCounterAttribute irqUnbound_;
+    IrqCounterAttribute irqSpurious_;
+    IrqStatAttribute irqStat_;
+    WorkStatAttribute workStat_;
+    ClockAttribute clockUs_;
+    ClockAttribute clockHi_;
+    WaitCounterAttribute busyWaitUs_;
+    WaitCounterAttribute waitTimeouts_;
+    ExecStatAttribute execStat_;
+    FwAttribute outputDeadband_;        // deadband of the next 'Output' enable
+    FwAttribute outputDrops_;           // 'Output' enables rejected by full list
+
+    KERNEL_GENERIC_OBJECTS(FW_STATIC_MEMBER)    // CAN database converter
+    TelemetryScheduler telemetry_;  // periodic attributes output
 
-    DbcConverter dbc_;        // CAN database converter
+ private:
+    static const FwStaticEntry ATTRIBUTES[];
 };
@@ -46,6 +46,7 @@ class HBridgeDriver : public FwObject,
     // TimerListenerInterface
     virtual uint64_t getTimerInterval() { return 10; }
     virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_REALTIME; }
 
     // Common methods:
     void startDcMotor(int idx, int8_t direction);
@@ -60,6 +61,7 @@ class HBridgeDriver : public FwObject,
             kind_ = Attr_Int8;
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override;
         virtual void post_write() override;
      protected:
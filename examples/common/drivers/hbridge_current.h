@@ -29,6 +29,7 @@ class SensorCurrent : public FwAttribute {
     SensorCurrent(FwObject *parent, const char *name, const char *adcport);
 
     // FwAttribute
+    virtual bool isPackable() override { return false; }
     virtual void pre_read() override;
 
     // Common interface
@@ -49,6 +49,7 @@ class DcMotor : public PwmInterface {
             make_int8(0);
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void post_write() override {
             if (to_int8()) {
                 ipwm_->enablePwm();
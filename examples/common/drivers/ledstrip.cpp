@@ -17,6 +17,7 @@
 #include <prjtypes.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwprof.h>
 #include "ledstrip.h"
 #include <uart.h>
 
@@ -37,6 +38,7 @@ int8_t tim_cnt_ = 0;
 
 extern "C" void TIM2_irq_handler() {
     TIM_registers_type *TIM2 = (TIM_registers_type *)TIM2_BASE;
+    uint32_t t0 = fwprof_irq_enter();
 
     if (++tim_cnt_ >= 100) {
         tim_cnt_ = 0;
@@ -52,6 +54,7 @@ extern "C" void TIM2_irq_handler() {
 
     write16(&TIM2->SR, 0);  // clear all pending bits
     nvic_irq_clear(28);
+    fwprof_irq_exit(28, t0);
 }
 
 // TIM2 is used as PWM period generator
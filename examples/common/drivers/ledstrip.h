@@ -36,6 +36,7 @@ class LedStripDriver : public FwObject {
      public:
         DutyAttribute(const char *name, int idx) : FwAttribute(name), idx_(idx) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override;
         virtual void post_write() override;
      protected:
@@ -46,6 +47,7 @@ class LedStripDriver : public FwObject {
      public:
         HzAttribute(const char *name) : FwAttribute(name) {}
 
+        virtual bool isPackable() override { return false; }
         virtual void post_write() override;
         virtual float getMinValue() override { return 10.0f; }
         virtual float getMaxValue() override { return 10000.0f; }
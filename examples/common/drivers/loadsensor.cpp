@@ -17,6 +17,10 @@
 #include <prjtypes.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwirq.h>
+#include <fwlat.h>
+#include <fwwork.h>
+#include <fwwait.h>
 #include <new>
 #include <uart.h>
 #include "loadsensor.h"
@@ -89,8 +93,6 @@ static const float INIT_TARA[GARDEMARIN_LOAD_SENSORS_TOTAL] = {
     0.0f
 };
 
-static IrqHandlerInterface *drivers_ = 0;
-
 static void startCounter(TIM_registers_type *TIM, int usec) {
     tim_cr1_reg_type cr1;
 
@@ -101,15 +103,20 @@ static void startCounter(TIM_registers_type *TIM, int usec) {
     cr1.bits.CEN = 1;
     cr1.bits.OPM = 1;   // one pulse mode
     cr1.bits.DIR = 1;   // downcount
+    fw_lat_arm(50, TIM, static_cast<uint32_t>(usec));
     write32(&TIM->CR1.val, cr1.val);
 }
 
 extern "C" void TIM5_irq_handler() {
     TIM_registers_type *TIM5 = (TIM_registers_type *)TIM5_BASE;
+    fw_lat_isr_entry(50);
 
     int nsec = 0;
-    if (drivers_) {
-        drivers_->handleInterrupt(&nsec);
+    // [0] UIF update interrupt flag
+    if ((read16(&TIM5->SR) & 0x1) == 0) {
+        fw_irq_spurious(50);
+    } else {
+        fw_irq_dispatch(50, &nsec);
     }
     // Convert nsec to timescale is 100 ns
     /*if (nsec) {
@@ -133,11 +140,12 @@ LoadSensorDriver::LoadSensorDriver(const char *name) : FwObject(name) {
 
     estate_ = Idle;
     bitCnt_ = 0;
-    drivers_ = static_cast<IrqHandlerInterface *>(this);
 
     for (int i = 0; i < GARDEMARIN_LOAD_SENSORS_TOTAL; i++) {
         chn_[i].port = new(fw_malloc(sizeof(LoadSensorPort)))
                LoadSensorPort(static_cast<FwObject *>(this), i);
+        chn_[i].shifter = 0;
+        chn_[i].value = 0;
     }
 
     selectChannel(-1);
@@ -183,6 +191,7 @@ void LoadSensorDriver::Init() {
     RegisterInterface(static_cast<IrqHandlerInterface *>(this));
     RegisterInterface(static_cast<RunInterface *>(this));
     RegisterInterface(static_cast<TimerListenerInterface *>(this));
+    fw_irq_bind(50, static_cast<IrqHandlerInterface *>(this));
 
     for (int i = 0; i < GARDEMARIN_LOAD_SENSORS_TOTAL; i++) {
         chn_[i].port->Init();
@@ -236,8 +245,9 @@ void LoadSensorDriver::handleInterrupt(int *argv) {
         if (++bitCnt_ >= 27) {
             estate_ = Sleep;
             for (int i = 0; i < GARDEMARIN_LOAD_SENSORS_TOTAL; i++) {
-                chn_[i].port->setSensorValue(chn_[i].shifter);
+                chn_[i].value = chn_[i].shifter;
             }
+            fw_work_post(FW_WORK_HIGH, publishWork, this, 0);
         } else {
             estate_ = SCK_HIGH;
         }
@@ -253,6 +263,13 @@ void LoadSensorDriver::handleInterrupt(int *argv) {
     }
 }
 
+void LoadSensorDriver::publishWork(void *ctx, uint32_t arg) {
+    LoadSensorDriver *p = static_cast<LoadSensorDriver *>(ctx);
+    for (int i = 0; i < GARDEMARIN_LOAD_SENSORS_TOTAL; i++) {
+        p->chn_[i].port->setSensorValue(p->chn_[i].value);
+    }
+}
+
 void LoadSensorDriver::selectChannel(int chidx) {
     GPIO_registers_type *P = (GPIO_registers_type *)GPIOD_BASE;
     uint32_t t1 = read32(&P->ODR);
@@ -264,8 +281,10 @@ void LoadSensorDriver::selectChannel(int chidx) {
 }
 
 void LoadSensorDriver::setSleep() {
+    // HX711 enters power down mode when SCK stays high longer than 60 us.
+    // Task context sleeps for this time instead of spinning.
     gpio_pin_set(&SPI3_SCK);
-    system_delay_ns(60000);
+    fw_wait_delay_us(60);
 }
 
 void LoadSensorDriver::callbackTimer(uint64_t tickcnt) {
@@ -325,11 +344,11 @@ LoadSensorPort::LoadSensorPort(FwObject *parent, int idx) :
     gpio_pin_set(&CELL_CONFIG[idx].cs_gpio_cfg);
 
     make_int32(0);
-    alpha_.make_float(INIT_ALPHA[idx]);
-    zero_.make_float(INIT_ZERO[idx]);
-    tara_.make_float(INIT_TARA[idx]);
-    gram_.make_float(0);
-    gramflt_.make_float(0);
+    alpha_.set(INIT_ALPHA[idx]);
+    zero_.set(INIT_ZERO[idx]);
+    tara_.set(INIT_TARA[idx]);
+    gram_.set(0);
+    gramflt_.set(0);
     v3of4[0] = 0;
     v3of4[1] = 0;
     v3of4[2] = 0;
@@ -354,8 +373,8 @@ void LoadSensorPort::setSensorValue(uint32_t val) {
     if (t1 & 0x04000000) {
         t1 |= 0xf8000000;
     }
-    float phys = static_cast<float>(t1) * alpha_.to_float();
-    phys += zero_.to_float() + tara_.to_float();
+    float phys = static_cast<float>(t1) * alpha_.get();
+    phys += zero_.get() + tara_.get();
 
     float dltphys;
     int validcnt = 0;
@@ -371,11 +390,11 @@ void LoadSensorPort::setSensorValue(uint32_t val) {
         }
     }
     if (validcnt >= 2) {
-        gram_.make_float(phys);
+        gram_.set(phys);
 
         fltacc_ -= 0.1f * fltacc_;
         fltacc_ += phys;
-        gramflt_.make_float(0.1f * fltacc_);
+        gramflt_.set(0.1f * fltacc_);
     }
 
     v3of4[2] = v3of4[1];
@@ -20,6 +20,7 @@
 #include <fwlist.h>
 #include <fwobject.h>
 #include <FwAttribute.h>
+#include <fwtypedattr.h>
 #include <RunInterface.h>
 #include <TimerInterface.h>
 #include <SensorInterface.h>
@@ -41,11 +42,11 @@ class LoadSensorPort : public FwAttribute,
 
  protected:
     FwObject *parent_;
-    FwAttribute alpha_;
-    FwAttribute zero_;
-    FwAttribute tara_;
-    FwAttribute gram_;
-    FwAttribute gramflt_;
+    TypedAttribute<float> alpha_;
+    TypedAttribute<float> zero_;
+    TypedAttribute<float> tara_;
+    TypedAttribute<float> gram_;
+    TypedAttribute<float> gramflt_;
     int idx_;
     float fltacc_;
     float v3of4[3];
@@ -72,11 +73,15 @@ class LoadSensorDriver : public FwObject,
     // TimerListenerInterface
     virtual uint64_t getTimerInterval() { return 100; }
     virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_REALTIME; }
 
  protected:
     // Accessed from channels:
     void selectChannel(int chidx);
 
+    // Deferred work handler (fwwork.h): filter results in task context
+    static void publishWork(void *ctx, uint32_t arg);
+
  protected:
 
     // for the fast access initialize in constructor the following pointers
@@ -84,6 +89,7 @@ class LoadSensorDriver : public FwObject,
     struct SensorType {
         LoadSensorPort *port;
         uint32_t shifter;
+        uint32_t value;         // latched result for the worker task
     } chn_[GARDEMARIN_LOAD_SENSORS_TOTAL];
 
     enum EState {
@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <fwapi.h>
+#include <string.h>
+#include "memstat.h"
+
+static_assert(MEMSTAT_TASKS_MAX == 9, "one StackN attribute per task");
+
+MemoryStatDriver::MemoryStatDriver(const char *name) : FwObject(name),
+    TimerListenerInterface(),
+    fwAllocated_("FwAllocated", "[bytes] fw_malloc arena used"),
+    heapFree_("HeapFree", "[bytes] FreeRTOS heap free"),
+    heapMinFree_("HeapMinFree", "[bytes] FreeRTOS heap minimum ever free"),
+    largeFree_("LargeFree", "[bytes] freed large blocks kept for reuse"),
+    allocFail_("AllocFail", "Number of failed allocations"),
+    badFree_("BadFree", "Number of invalid fw_mem_free() calls"),
+    taskCount_("TaskCount", "Number of FreeRTOS tasks"),
+    stack0_("Stack0", "[bytes] stack high water mark of the task in slot 0"),
+    stack1_("Stack1", "[bytes] stack high water mark of the task in slot 1"),
+    stack2_("Stack2", "[bytes] stack high water mark of the task in slot 2"),
+    stack3_("Stack3", "[bytes] stack high water mark of the task in slot 3"),
+    stack4_("Stack4", "[bytes] stack high water mark of the task in slot 4"),
+    stack5_("Stack5", "[bytes] stack high water mark of the task in slot 5"),
+    stack6_("Stack6", "[bytes] stack high water mark of the task in slot 6"),
+    stack7_("Stack7", "[bytes] stack high water mark of the task in slot 7"),
+    stack8_("Stack8", "[bytes] stack high water mark of the task in slot 8") {
+    stack_[0] = &stack0_;
+    stack_[1] = &stack1_;
+    stack_[2] = &stack2_;
+    stack_[3] = &stack3_;
+    stack_[4] = &stack4_;
+    stack_[5] = &stack5_;
+    stack_[6] = &stack6_;
+    stack_[7] = &stack7_;
+    stack_[8] = &stack8_;
+    fwAllocated_.make_uint32(0);
+    heapFree_.make_uint32(0);
+    heapMinFree_.make_uint32(0);
+    largeFree_.make_uint32(0);
+    allocFail_.make_uint32(0);
+    badFree_.make_uint32(0);
+    taskCount_.make_uint8(0);
+    for (int i = 0; i < MEMSTAT_TASKS_MAX; i++) {
+        stack_[i]->make_uint32(0);
+        names_[i][0] = '\0';
+        seen_[i] = false;
+    }
+}
+
+void MemoryStatDriver::Init() {
+    RegisterAttribute(&fwAllocated_);
+    RegisterAttribute(&heapFree_);
+    RegisterAttribute(&heapMinFree_);
+    RegisterAttribute(&largeFree_);
+    RegisterAttribute(&allocFail_);
+    RegisterAttribute(&badFree_);
+    RegisterAttribute(&taskCount_);
+    for (int i = 0; i < MEMSTAT_TASKS_MAX; i++) {
+        RegisterAttribute(stack_[i]);
+    }
+    RegisterInterface(static_cast<TimerListenerInterface *>(this));
+    updateHeap();
+}
+
+void MemoryStatDriver::callbackTimer(uint64_t tickcnt) {
+    updateHeap();
+    updateStacks();
+}
+
+void MemoryStatDriver::updateHeap() {
+    fwAllocated_.make_uint32(fw_mem_get_allocated_size());
+    heapFree_.make_uint32(static_cast<uint32_t>(xPortGetFreeHeapSize()));
+    heapMinFree_.make_uint32(
+        static_cast<uint32_t>(xPortGetMinimumEverFreeHeapSize()));
+    largeFree_.make_uint32(fw_mem_get_large_free_size());
+    allocFail_.make_uint32(fw_mem_get_overflow_count());
+    badFree_.make_uint32(fw_mem_get_invalid_free_count());
+}
+
+/**
+ * @brief Slot of the stack attribute is bound to the task name on the first
+ *        report of the task, so the slot doesn't move when tasks are created
+ *        or deleted. Slot of a deleted task keeps its name and reports 0.
+ */
+int MemoryStatDriver::getStackSlot(const char *taskname) {
+    int freeslot = -1;
+    for (int i = 0; i < MEMSTAT_TASKS_MAX; i++) {
+        if (names_[i][0] == '\0') {
+            if (freeslot < 0) {
+                freeslot = i;
+            }
+            continue;
+        }
+        if (strncmp(names_[i], taskname, configMAX_TASK_NAME_LEN) == 0) {
+            return i;
+        }
+    }
+    if (freeslot >= 0) {
+        strncpy(names_[freeslot], taskname, configMAX_TASK_NAME_LEN - 1);
+        names_[freeslot][configMAX_TASK_NAME_LEN - 1] = '\0';
+    }
+    return freeslot;
+}
+
+void MemoryStatDriver::updateStacks() {
+    UBaseType_t total;
+    int slot;
+
+    // Returns 0 if the array is too small for all tasks: keep the previous
+    // stack values instead of reporting a partial snapshot.
+    total = uxTaskGetSystemState(status_, MEMSTAT_TASKS_MAX, 0);
+    if (total == 0) {
+        taskCount_.make_uint8(static_cast<uint8_t>(uxTaskGetNumberOfTasks()));
+        return;
+    }
+    taskCount_.make_uint8(static_cast<uint8_t>(total));
+    for (int i = 0; i < MEMSTAT_TASKS_MAX; i++) {
+        seen_[i] = false;
+    }
+    for (UBaseType_t i = 0; i < total; i++) {
+        slot = getStackSlot(status_[i].pcTaskName);
+        if (slot < 0) {
+            continue;
+        }
+        seen_[slot] = true;
+        stack_[slot]->make_uint32(static_cast<uint32_t>(
+            status_[i].usStackHighWaterMark * sizeof(StackType_t)));
+    }
+    for (int i = 0; i < MEMSTAT_TASKS_MAX; i++) {
+        if (!seen_[i]) {
+            stack_[i]->make_uint32(0);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+
+#include <prjtypes.h>
+#include <fwlist.h>
+#include <fwobject.h>
+#include <FwAttribute.h>
+#include <TimerInterface.h>
+#include <FreeRTOS.h>
+#include <task.h>
+
+/** Maximum number of FreeRTOS tasks reported by the stack attributes */
+#define MEMSTAT_TASKS_MAX configFW_TASKS_TOTAL
+
+class MemoryStatDriver : public FwObject,
+                         public TimerListenerInterface {
+ public:
+    explicit MemoryStatDriver(const char *name);
+
+    // FwObject interface:
+    virtual void Init() override;
+
+    // TimerListenerInterface
+    virtual uint64_t getTimerInterval() override { return 1000; }
+    virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_BACKGROUND; }
+
+ protected:
+    void updateHeap();
+    void updateStacks();
+    int getStackSlot(const char *taskname);
+
+ protected:
+    FwAttribute fwAllocated_;
+    FwAttribute heapFree_;
+    FwAttribute heapMinFree_;
+    FwAttribute largeFree_;
+    FwAttribute allocFail_;
+    FwAttribute badFree_;
+    FwAttribute taskCount_;
+    FwAttribute stack0_;
+    FwAttribute stack1_;
+    FwAttribute stack2_;
+    FwAttribute stack3_;
+    FwAttribute stack4_;
+    FwAttribute stack5_;
+    FwAttribute stack6_;
+    FwAttribute stack7_;
+    FwAttribute stack8_;
+    FwAttribute *stack_[MEMSTAT_TASKS_MAX];     // indexed by slot
+
+    TaskStatus_t status_[MEMSTAT_TASKS_MAX];
+    char names_[MEMSTAT_TASKS_MAX][configMAX_TASK_NAME_LEN];   // slot owner
+    bool seen_[MEMSTAT_TASKS_MAX];
+};
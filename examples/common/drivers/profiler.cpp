@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <string.h>
+#include <fwapi.h>
+#include <FreeRTOS.h>
+#include <fwlat.h>
+#include "profiler.h"
+
+ProfilerDriver::ProfilerDriver(const char *name) : FwObject(name),
+    TimerListenerInterface(),
+    enable_(this, "Enable"),
+    reset_(this, "Reset"),
+    select_(this, "Select"),
+    load_("Load", "[%] CPU load of the selected task/irq, last second"),
+    maxUs_("MaxUs", "[us] longest execution of the selected task/irq"),
+    count_("Count", "Activations of the selected task/irq"),
+    lastCycles_(0) {
+    load_.make_float(0);
+    maxUs_.make_uint32(0);
+    count_.make_uint32(0);
+    memset(lastTask_, 0, sizeof(lastTask_));
+    memset(lastIrq_, 0, sizeof(lastIrq_));
+    memset(loadTask_, 0, sizeof(loadTask_));
+    memset(loadIrq_, 0, sizeof(loadIrq_));
+}
+
+void ProfilerDriver::Init() {
+    RegisterAttribute(&enable_);
+    RegisterAttribute(&reset_);
+    RegisterAttribute(&select_);
+    RegisterAttribute(&load_);
+    RegisterAttribute(&maxUs_);
+    RegisterAttribute(&count_);
+    RegisterInterface(static_cast<TimerListenerInterface *>(this));
+}
+
+void ProfilerDriver::enable(int ena) {
+    fwprof_enable(ena ? 1 : 0);
+    reset();
+}
+
+void ProfilerDriver::reset() {
+    fwprof_reset();
+    fw_lat_reset();
+    lastCycles_ = fwprof_get_cycles();
+    memset(lastTask_, 0, sizeof(lastTask_));
+    memset(lastIrq_, 0, sizeof(lastIrq_));
+    memset(loadTask_, 0, sizeof(loadTask_));
+    memset(loadIrq_, 0, sizeof(loadIrq_));
+    updateSelected();
+}
+
+void ProfilerDriver::select(uint8_t sel) {
+    updateSelected();
+}
+
+FwProfStat *ProfilerDriver::selectedStat() {
+    uint8_t sel = select_.to_uint8();
+    if (sel & 0x80) {
+        return fwprof_get_irq_stat(sel & 0x7F);
+    }
+    return fwprof_get_task_stat(sel & 0x7F);
+}
+
+void ProfilerDriver::updateSelected() {
+    FwProfStat *p = selectedStat();
+    uint8_t sel = select_.to_uint8();
+    uint32_t clk_per_us = static_cast<uint32_t>(SystemCoreClock / 1000000);
+    int idx = sel & 0x7F;
+
+    if (p == 0) {
+        load_.make_float(0);
+        maxUs_.make_uint32(0);
+        count_.make_uint32(0);
+        return;
+    }
+    if (sel & 0x80) {
+        load_.make_float(loadIrq_[idx]);
+    } else {
+        load_.make_float(loadTask_[idx]);
+    }
+    maxUs_.make_uint32(p->max / clk_per_us);
+    count_.make_uint32(p->count);
+}
+
+void ProfilerDriver::callbackTimer(uint64_t tickcnt) {
+    FwProfStat *p;
+    uint32_t now;
+    float window;
+
+    if (!fwprof_enabled_) {
+        return;
+    }
+    now = fwprof_get_cycles();
+    window = static_cast<float>(now - lastCycles_);
+    lastCycles_ = now;
+    if (window == 0) {
+        return;
+    }
+
+    for (int i = 0; i < FWPROF_TASKS_MAX; i++) {
+        p = fwprof_get_task_stat(i);
+        loadTask_[i] = 100.0f * static_cast<float>(p->cycles - lastTask_[i]) / window;
+        lastTask_[i] = p->cycles;
+    }
+    for (int i = 0; i < FWPROF_IRQ_MAX; i++) {
+        p = fwprof_get_irq_stat(i);
+        loadIrq_[i] = 100.0f * static_cast<float>(p->cycles - lastIrq_[i]) / window;
+        lastIrq_[i] = p->cycles;
+    }
+    updateSelected();
+}
@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <prjtypes.h>
+#include <fwlist.h>
+#include <fwobject.h>
+#include <FwAttribute.h>
+#include <TimerInterface.h>
+#include <fwprof.h>
+
+/**
+ * @brief CPU load of the FreeRTOS tasks and interrupt handlers measured by
+ *        DWT cycle counter (fwprof.c). One task or vector is selected by
+ *        'Select' attribute: [7] 0=task, 1=irq; [6:0] task number - 1 or
+ *        NVIC index. Load is recomputed once per second.
+ */
+class ProfilerDriver : public FwObject,
+                       public TimerListenerInterface {
+ public:
+    explicit ProfilerDriver(const char *name);
+
+    // FwObject interface:
+    virtual void Init() override;
+
+    // TimerListenerInterface
+    virtual uint64_t getTimerInterval() override { return 1000; }
+    virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_BACKGROUND; }
+
+    // Common methods:
+    void enable(int ena);
+    void reset();
+    void select(uint8_t sel);
+
+ protected:
+    class EnableAttribute : public FwAttribute {
+     public:
+        EnableAttribute(ProfilerDriver *parent, const char *name)
+            : FwAttribute(name, "1=start profiling, 0=stop"), parent_(parent) {
+            make_uint8(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void post_write() override {
+            parent_->enable(u_.u8);
+        }
+     protected:
+        ProfilerDriver *parent_;
+    };
+
+    class ResetAttribute : public FwAttribute {
+     public:
+        ResetAttribute(ProfilerDriver *parent, const char *name)
+            : FwAttribute(name, "Write any value to clear statistic"),
+            parent_(parent) {
+            make_uint8(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void post_write() override {
+            parent_->reset();
+        }
+     protected:
+        ProfilerDriver *parent_;
+    };
+
+    class SelectAttribute : public FwAttribute {
+     public:
+        SelectAttribute(ProfilerDriver *parent, const char *name)
+            : FwAttribute(name, "[7] 0=task, 1=irq; [6:0] index"),
+            parent_(parent) {
+            make_uint8(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void post_write() override {
+            parent_->select(u_.u8);
+        }
+     protected:
+        ProfilerDriver *parent_;
+    };
+
+    FwProfStat *selectedStat();
+    void updateSelected();
+
+ protected:
+    EnableAttribute enable_;
+    ResetAttribute reset_;
+    SelectAttribute select_;
+    FwAttribute load_;
+    FwAttribute maxUs_;
+    FwAttribute count_;
+
+    uint32_t lastCycles_;
+    uint32_t lastTask_[FWPROF_TASKS_MAX];
+    uint32_t lastIrq_[FWPROF_IRQ_MAX];
+    float loadTask_[FWPROF_TASKS_MAX];
+    float loadIrq_[FWPROF_IRQ_MAX];
+};
@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <fwapi.h>
+#include "pwrstat.h"
+
+// Updated by the idle task with the scheduler suspended
+static volatile uint32_t sleep_start_ = 0;
+static volatile uint32_t sleep_ticks_ = 0;
+static volatile uint32_t sleep_cnt_ = 0;
+static volatile uint32_t sleep_max_ = 0;
+
+extern "C" void pwrstat_sleep_begin(void) {
+    sleep_start_ = static_cast<uint32_t>(xTaskGetTickCount());
+}
+
+/**
+ * @brief Tick counter was already stepped by the slept period
+ */
+extern "C" void pwrstat_sleep_end(void) {
+    uint32_t dt = static_cast<uint32_t>(xTaskGetTickCount()) - sleep_start_;
+    sleep_ticks_ += dt;
+    sleep_cnt_++;
+    if (dt > sleep_max_) {
+        sleep_max_ = dt;
+    }
+}
+
+PowerStatDriver::PowerStatDriver(const char *name) : FwObject(name),
+    TimerListenerInterface(),
+    sleepPct_("SleepPct", "[%] time in tickless sleep, last second"),
+    sleepCount_("SleepCount", "Number of tickless sleeps"),
+    sleepMax_("SleepMax", "[ms] longest sleep, last second"),
+    sleepTotal_("SleepTotal", "[ms] total time in tickless sleep"),
+    lastTick_(0),
+    lastSleep_(0) {
+    sleepPct_.make_float(0);
+    sleepCount_.make_uint32(0);
+    sleepMax_.make_uint32(0);
+    sleepTotal_.make_uint32(0);
+}
+
+void PowerStatDriver::Init() {
+    RegisterAttribute(&sleepPct_);
+    RegisterAttribute(&sleepCount_);
+    RegisterAttribute(&sleepMax_);
+    RegisterAttribute(&sleepTotal_);
+    RegisterInterface(static_cast<TimerListenerInterface *>(this));
+}
+
+void PowerStatDriver::callbackTimer(uint64_t tickcnt) {
+    uint32_t tick;
+    uint32_t slept;
+    uint32_t smax;
+
+    vTaskSuspendAll();
+    tick = static_cast<uint32_t>(xTaskGetTickCount());
+    slept = sleep_ticks_;
+    smax = sleep_max_;
+    sleep_max_ = 0;
+    xTaskResumeAll();
+
+    if (tick != lastTick_) {
+        sleepPct_.make_float(100.0f * static_cast<float>(slept - lastSleep_)
+                           / static_cast<float>(tick - lastTick_));
+    }
+    sleepCount_.make_uint32(sleep_cnt_);
+    sleepMax_.make_uint32(smax * portTICK_PERIOD_MS);
+    sleepTotal_.make_uint32(slept * portTICK_PERIOD_MS);
+    lastTick_ = tick;
+    lastSleep_ = slept;
+}
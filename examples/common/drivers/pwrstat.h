@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+#pragma once
+
+#include <prjtypes.h>
+#include <fwlist.h>
+#include <fwobject.h>
+#include <FwAttribute.h>
+#include <TimerInterface.h>
+#include <FreeRTOS.h>
+#include <task.h>
+
+/**
+ * @brief Tickless idle statistic. FreeRTOS idle task calls
+ *        pwrstat_sleep_begin/end() around portSUPPRESS_TICKS_AND_SLEEP()
+ *        and the residency is computed once per second.
+ */
+class PowerStatDriver : public FwObject,
+                        public TimerListenerInterface {
+ public:
+    explicit PowerStatDriver(const char *name);
+
+    // FwObject interface:
+    virtual void Init() override;
+
+    // TimerListenerInterface
+    virtual uint64_t getTimerInterval() override { return 1000; }
+    virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_BACKGROUND; }
+
+ protected:
+    FwAttribute sleepPct_;
+    FwAttribute sleepCount_;
+    FwAttribute sleepMax_;
+    FwAttribute sleepTotal_;
+
+    uint32_t lastTick_;
+    uint32_t lastSleep_;
+};
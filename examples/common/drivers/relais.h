@@ -42,6 +42,7 @@ class RelaisDriver : public FwObject,
             FwAttribute(name,"0=ena, 1=dis"), parent_(parent) {
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override {
             u_.u8 = parent_->getBinState();
         }
@@ -35,6 +35,7 @@ class RtcDriver : public FwObject {
             kind_ = Attr_UInt32;
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override;
         virtual void post_write() override;
      private:
@@ -48,6 +49,7 @@ class RtcDriver : public FwObject {
             kind_ = Attr_UInt32;
         }
 
+        virtual bool isPackable() override { return false; }
         virtual void pre_read() override;
         virtual void post_write() override;
      private:
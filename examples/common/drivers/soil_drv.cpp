@@ -33,18 +33,18 @@ static const gpio_pin_type tx_pin = {
     (GPIO_registers_type *)GPIOD_BASE, 5
 };
 
-static FwFifo *prxFifo_ = 0;
-static FwFifo *ptxFifo_ = 0;
+static FwRing *prxRing_ = 0;
+static FwRing *ptxRing_ = 0;
 
 //
 extern "C" void USART2_irq_handler() {
     USART_registers_type *dev = (USART_registers_type *)USART2_BASE;
-    uint16_t rbyte;
+    char rbyte;
     char tbyte;
     while ((read16(&dev->SR) & (1 << 5)) != 0) {    // [5] RXNE: read data register not empty
-        rbyte = read16(&dev->DR);
-        if (prxFifo_) {
-            fw_fifo_put(prxFifo_, static_cast<char>(rbyte));
+        rbyte = static_cast<char>(read16(&dev->DR));
+        if (prxRing_) {
+            fw_ring_write(prxRing_, &rbyte, 1);
         }
     }
 
@@ -58,8 +58,7 @@ extern "C" void USART2_irq_handler() {
         // TXE is set. An interrupt is generated if TCIE=1 in the USART_CR1 register. It is cleared by
         // a software sequence (a read from the USART_SR register followed by a write to the
         // USART_DR register). 
-        if (ptxFifo_ && !fw_fifo_is_empty(ptxFifo_)) {
-            fw_fifo_get(ptxFifo_, &tbyte);
+        if (ptxRing_ && fw_ring_read(ptxRing_, &tbyte, 1)) {
             write16(&dev->DR, static_cast<uint16_t>(tbyte));
         } else {
             write16(&dev->SR, 0);
@@ -132,11 +131,11 @@ SoilDriver::SoilDriver(const char *name)
     write16(&UART2->CR2, 0);
     write16(&UART2->CR3, 0);
 
-    fw_fifo_init(&rxfifo_, 2*sizeof(DataResponseType));
-    prxFifo_ = &rxfifo_;
+    fw_ring_init(&rxring_, 1, 2*sizeof(DataResponseType));
+    prxRing_ = &rxring_;
 
-    fw_fifo_init(&txfifo_, 2*sizeof(queryData_));
-    ptxFifo_ = &txfifo_;
+    fw_ring_init(&txring_, 1, 2*sizeof(queryData_));
+    ptxRing_ = &txring_;
 
 }
 
@@ -157,55 +156,50 @@ void SoilDriver::Init() {
 
 
 void SoilDriver::callbackTimer(uint64_t tickcnt) {
-    char *xbyte = reinterpret_cast<char *>(&response_);
-    int rxcnt = 0;
+    uint32_t primask;
     uint16_t v;
 
-    while (!fw_fifo_is_empty(&rxfifo_)) {
-        fw_fifo_get(&rxfifo_, xbyte++);
-        if (++rxcnt >= sizeof(response_)) {
-            xbyte = reinterpret_cast<char *>(&response_);
-            rxcnt = 0;
-            v = response_.temp[0];
-            v |= (v << 8) | response_.temp[1];
-            T_.make_uint16(v);
-
-            v = response_.moisture[0];
-            v |= (v << 8) | response_.moisture[1];
-            moisture_.make_uint16(v);
-
-            v = response_.salinty[0];
-            v |= (v << 8) | response_.salinty[1];
-            salnity_.make_uint16(v);
-
-            v = response_.EC[0];
-            v |= (v << 8) | response_.EC[1];
-            EC_.make_uint16(v);
-
-            v = response_.pH[0];
-            v |= (v << 8) | response_.pH[1];
-            pH_.make_uint16(v);
-
-            v = response_.N[0];
-            v |= (v << 8) | response_.N[1];
-            N_.make_uint16(v);
-
-            v = response_.P[0];
-            v |= (v << 8) | response_.P[1];
-            P_.make_uint16(v);
-
-            v = response_.K[0];
-            v |= (v << 8) | response_.K[1];
-            K_.make_uint16(v);
-        }
-    }
+    // Partially received response stays in the ring until the next call
+    while (fw_ring_get_count(&rxring_) >= static_cast<int>(sizeof(response_))) {
+        fw_ring_read(&rxring_, &response_, sizeof(response_));
+        v = response_.temp[0];
+        v |= (v << 8) | response_.temp[1];
+        T_.make_uint16(v);
+
+        v = response_.moisture[0];
+        v |= (v << 8) | response_.moisture[1];
+        moisture_.make_uint16(v);
+
+        v = response_.salinty[0];
+        v |= (v << 8) | response_.salinty[1];
+        salnity_.make_uint16(v);
+
+        v = response_.EC[0];
+        v |= (v << 8) | response_.EC[1];
+        EC_.make_uint16(v);
 
-    xbyte = reinterpret_cast<char *>(&queryData_);
-    for (int i = 0; i < sizeof(QueryDataType); i++) {
-        fw_fifo_put(&txfifo_, *xbyte);
-        xbyte++;
+        v = response_.pH[0];
+        v |= (v << 8) | response_.pH[1];
+        pH_.make_uint16(v);
+
+        v = response_.N[0];
+        v |= (v << 8) | response_.N[1];
+        N_.make_uint16(v);
+
+        v = response_.P[0];
+        v |= (v << 8) | response_.P[1];
+        P_.make_uint16(v);
+
+        v = response_.K[0];
+        v |= (v << 8) | response_.K[1];
+        K_.make_uint16(v);
     }
 
+    fw_ring_write(&txring_, &queryData_, sizeof(QueryDataType));
+
+    // Interrupt handler is the only consumer of the tx ring
+    primask = DisableIrqSave();
     USART2_irq_handler();
+    RestoreIrq(primask);
 }
 
@@ -18,7 +18,7 @@
 #include <prjtypes.h>
 #include <fwlist.h>
 #include <fwobject.h>
-#include <fwfifo.h>
+#include <fwring.h>
 #include <FwAttribute.h>
 #include <TimerInterface.h>
 
@@ -78,8 +78,8 @@ class SoilDriver : public FwObject,
     FwAttribute P_;
     FwAttribute K_;
 
-    FwFifo rxfifo_;
-    FwFifo txfifo_;
+    FwRing rxring_;
+    FwRing txring_;
     QueryDataType queryData_;
     DataResponseType response_;
 };
@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <string.h>
+#include <fwapi.h>
+#include <canframe.h>
+#include "telemetry.h"
+
+static portTASK_FUNCTION(taskTelemetry, args) {
+    reinterpret_cast<TelemetryScheduler *>(args)->run();
+}
+
+TelemetryScheduler::TelemetryScheduler() : iraw_(0), task_(0), txcnt_(0) {
+    memset(entries_, 0, sizeof(entries_));
+    memset(ican_, 0, sizeof(ican_));
+}
+
+void TelemetryScheduler::start() {
+    static const char *CAN_BUSES[DBC_CAN_BUSES] = {"can1", "can2"};
+
+    iraw_ = reinterpret_cast<RawInterface *>(
+        fw_get_object_interface("uart1", "RawInterface"));
+    for (int i = 0; i < DBC_CAN_BUSES; i++) {
+        ican_[i] = reinterpret_cast<CanInterface *>(
+            fw_get_object_interface(CAN_BUSES[i], "CanInterface"));
+    }
+
+    xTaskCreate(taskTelemetry,
+                "tlm",
+                256,
+                this,
+                tskIDLE_PRIORITY + 1UL,
+                &task_);
+}
+
+bool TelemetryScheduler::add(int objid,
+                             int attrid,
+                             FwAttribute *attr,
+                             uint32_t period,
+                             float deadband) {
+    EntryType *e = 0;
+
+    // The same lock as remove() and the snapshot in process()
+    taskENTER_CRITICAL();
+    for (int i = 0; i < TELEMETRY_ENTRIES_MAX; i++) {
+        if (entries_[i].used && entries_[i].attr == attr) {
+            e = &entries_[i];
+            break;
+        }
+        if (e == 0 && !entries_[i].used) {
+            e = &entries_[i];
+        }
+    }
+    if (e) {
+        e->attr = attr;
+        e->objid = static_cast<uint8_t>(objid);
+        e->attrid = static_cast<uint8_t>(attrid);
+        e->period = pdMS_TO_TICKS(period);
+        e->next = xTaskGetTickCount();
+        e->sent = 0;
+        e->deadband = deadband < 0 ? -deadband : deadband;
+        e->pgvalid = 0;
+        e->gen++;
+        e->used = 1;
+    }
+    taskEXIT_CRITICAL();
+
+    if (e == 0) {
+        // Counted by the caller, any text would break the DBC stream
+        return false;
+    }
+    if (task_) {
+        xTaskNotifyGive(task_);
+    }
+    return true;
+}
+
+void TelemetryScheduler::remove(FwAttribute *attr) {
+    taskENTER_CRITICAL();
+    for (int i = 0; i < TELEMETRY_ENTRIES_MAX; i++) {
+        if (entries_[i].used && entries_[i].attr == attr) {
+            entries_[i].used = 0;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+bool TelemetryScheduler::isEmpty() {
+    for (int i = 0; i < TELEMETRY_ENTRIES_MAX; i++) {
+        if (entries_[i].used) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TelemetryScheduler::run() {
+    TickType_t tlast = xTaskGetTickCount();
+    while (1) {
+        if (isEmpty()) {
+            // Do not wake up every tick without output, so tickless idle
+            // can sleep until the next deadline. Woken up by add().
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            tlast = xTaskGetTickCount();
+            continue;
+        }
+        vTaskDelayUntil(&tlast, pdMS_TO_TICKS(TELEMETRY_TICK_MS));
+        process(tlast);
+    }
+}
+
+/**
+ * @brief Write back the output state of the snapshot unless add() or
+ *        remove() modified the entry after the snapshot was taken
+ */
+void TelemetryScheduler::commitState(int i, EntryType *e) {
+    taskENTER_CRITICAL();
+    if (entries_[i].used && entries_[i].attr == e->attr
+        && entries_[i].gen == e->gen) {
+        entries_[i].next = e->next;
+        entries_[i].sent = e->sent;
+        entries_[i].last = e->last;
+        entries_[i].lastnum = e->lastnum;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void TelemetryScheduler::process(TickType_t tnow) {
+    EntryType e;
+    can_frame_type frame;
+    FwObject *obj;
+    char tbuf[8];
+    uint16_t pages[TELEMETRY_ENTRIES_MAX];
+    int pagecnt = 0;
+    uint16_t key;
+    uint8_t page;
+    uint64_t raw;
+    float num;
+    float dlt;
+    int bytesz;
+    int n;
+
+    for (int i = 0; i < TELEMETRY_ENTRIES_MAX; i++) {
+        // Snapshot to be consistent with add() from the DBC request
+        taskENTER_CRITICAL();
+        e = entries_[i];
+        taskEXIT_CRITICAL();
+
+        if (!e.used) {
+            continue;
+        }
+        if (e.period) {
+            if (static_cast<int32_t>(tnow - e.next) < 0) {
+                continue;
+            }
+            e.next = tnow + e.period;
+            commitState(i, &e);
+        }
+
+        // 64-bits values do not fit into one frame with the index byte
+        bytesz = e.attr->BitSize() / 8;
+        if (bytesz > 7) {
+            bytesz = 7;
+        }
+        e.attr->read(tbuf, sizeof(tbuf));
+
+        if (e.period == 0 && e.deadband != 0) {
+            // Change of value more than deadband, read() updated the value
+            num = e.attr->to_numeric();
+            dlt = num - e.lastnum;
+            if (dlt < 0) {
+                dlt = -dlt;
+            }
+            if (e.sent && dlt < e.deadband) {
+                continue;
+            }
+            e.lastnum = num;
+            e.sent = 1;
+            commitState(i, &e);
+        } else if (e.period == 0) {
+            // Change of value
+            raw = 0;
+            memcpy(&raw, tbuf, bytesz);
+            if (e.sent && raw == e.last) {
+                continue;
+            }
+            e.last = raw;
+            e.sent = 1;
+            commitState(i, &e);
+        }
+
+        if (!e.pgvalid) {
+            // Layout depends only on the object attributes list, compute it
+            // once per entry instead of on every output
+            e.pg.page = DBC_PACK_NONE;
+            obj = reinterpret_cast<FwObject *>(fw_get_obj_by_index(e.objid));
+            if (obj && e.attrid < DBC_PACK_ATTR_MAX) {
+                DbcConverter::packLayout(obj, &layout_);
+                if (layout_.page[e.attrid] != DBC_PACK_NONE) {
+                    DbcConverter::getPackedPage(&layout_,
+                                                layout_.page[e.attrid],
+                                                &e.pg);
+                }
+            }
+            e.pgvalid = 1;
+            taskENTER_CRITICAL();
+            if (entries_[i].attr == e.attr && entries_[i].gen == e.gen
+                && !entries_[i].pgvalid) {
+                entries_[i].pg = e.pg;
+                entries_[i].pgvalid = 1;
+            }
+            taskEXIT_CRITICAL();
+        }
+        page = e.pg.page;
+        if (page == DBC_PACK_NONE) {
+            frame.id = CAN_ID_EXT | OBJ_MSG_ID(e.objid);
+            frame.data.u8[0] = e.attrid;
+            memcpy(&frame.data.u8[1], tbuf, bytesz);
+            frame.dlc = static_cast<uint8_t>(1 + bytesz);
+            output(&frame);
+            continue;
+        }
+
+        // Entries of the same page share one frame in this tick
+        key = static_cast<uint16_t>((e.objid << 8) | page);
+        for (n = 0; n < pagecnt; n++) {
+            if (pages[n] == key) {
+                break;
+            }
+        }
+        if (n < pagecnt) {
+            continue;
+        }
+        pages[pagecnt++] = key;
+
+        obj = reinterpret_cast<FwObject *>(fw_get_obj_by_index(e.objid));
+        DbcConverter::encodePackedPage(e.objid, obj, &e.pg, &frame);
+        output(&frame);
+    }
+    flush();
+}
+
+void TelemetryScheduler::output(can_frame_type *frame) {
+    // Not queued while the bus is silent or the transmit queue is full
+    for (int i = 0; i < DBC_CAN_BUSES; i++) {
+        if (ican_[i]) {
+            ican_[i]->WriteCanFrame(frame);
+        }
+    }
+    if (txcnt_ + DbcConverter::DBC_TX_LINE_MAX > static_cast<int>(sizeof(txbuf_))) {
+        flush();
+    }
+    txcnt_ += DbcConverter::formatTxCanFrame(frame, &txbuf_[txcnt_]);
+}
+
+void TelemetryScheduler::flush() {
+    if (txcnt_ && iraw_) {
+        iraw_->WriteData(txbuf_, txcnt_);
+    }
+    txcnt_ = 0;
+}
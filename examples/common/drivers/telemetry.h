@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+
+#include <prjtypes.h>
+#include <FwAttribute.h>
+#include <RawInterface.h>
+#include "dbc.h"
+#include <FreeRTOS.h>
+#include <task.h>
+
+/** Maximum number of attributes in the periodic output list */
+#define TELEMETRY_ENTRIES_MAX 16
+
+/** Scheduler resolution in ms */
+#define TELEMETRY_TICK_MS 10
+
+/**
+ * @brief Push based attribute output. Attributes are enabled by the host
+ *        through the kernel 'Output' attribute and sent in the same format
+ *        as the DBC read response, so the host does not need any request.
+ *        Attribute is sent as the packed page it belongs to, entries of
+ *        the same page that are due in one tick share one frame. The page
+ *        is computed once per entry and cached until the next add().
+ *        All frames that are ready in one scheduler tick are coalesced
+ *        into one uart write from the single low priority task. The same
+ *        frames are queued on the CAN buses that are not silent.
+ */
+class TelemetryScheduler {
+ public:
+    TelemetryScheduler();
+
+    /**
+     * @brief Create output task and resolve output interface. Should be
+     *        called in PostInit() stage.
+     */
+    void start();
+
+    /**
+     * @brief Add attribute into output list or update its period
+     * @param[in] objid Object index used in DBC frame ID
+     * @param[in] attrid Attribute index used in DBC frame payload
+     * @param[in] attr Pointer to the attribute
+     * @param[in] period Output period in ms. Zero means output on change
+     *                   of the value checked every TELEMETRY_TICK_MS.
+     * @param[in] deadband Minimal absolute change of the numeric value
+     *                   to output when period is zero, 0 = any change.
+     * @return false if the list is full and the attribute wasn't added
+     */
+    bool add(int objid, int attrid, FwAttribute *attr, uint32_t period,
+             float deadband);
+
+    /**
+     * @brief Remove attribute from the output list
+     */
+    void remove(FwAttribute *attr);
+
+    /**
+     * @brief Task body
+     */
+    void run();
+
+ protected:
+    void process(TickType_t tnow);
+    bool isEmpty();
+    void flush();
+    void output(can_frame_type *frame);
+
+ protected:
+    struct EntryType {
+        FwAttribute *attr;
+        uint8_t objid;
+        uint8_t attrid;
+        uint8_t used;
+        uint8_t sent;       // last value is valid
+        uint32_t period;    // in ticks, 0 = on change
+        TickType_t next;    // tick of the next output
+        uint64_t last;      // last sent raw value
+        float deadband;     // on change output threshold, 0 = raw compare
+        float lastnum;      // last sent numeric value with deadband
+        uint8_t pgvalid;    // pg is computed, cleared by add()
+        uint8_t gen;        // incremented by each add() of the entry
+        DbcPackPage pg;     // packed page of the attribute
+    } entries_[TELEMETRY_ENTRIES_MAX];
+
+    void commitState(int i, EntryType *e);
+
+    DbcPackLayout layout_;      // used by the telemetry task only
+    RawInterface *iraw_;
+    CanInterface *ican_[DBC_CAN_BUSES];
+    TaskHandle_t task_;
+    char txbuf_[160];
+    int txcnt_;
+};
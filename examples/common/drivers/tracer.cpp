@@ -0,0 +1,70 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <fwapi.h>
+#include <FreeRTOS.h>
+#include <uart.h>
+#include "tracer.h"
+
+TraceDriver::TraceDriver(const char *name) : FwObject(name),
+    enable_("Enable"),
+    count_("Count"),
+    overrun_("Overrun"),
+    dump_("Dump") {
+}
+
+void TraceDriver::Init() {
+    RegisterAttribute(&enable_);
+    RegisterAttribute(&count_);
+    RegisterAttribute(&overrun_);
+    RegisterAttribute(&dump_);
+}
+
+/**
+ * Recording is suspended while printing, otherwise the UART interrupts
+ * overwrite the ring. Output format:
+ *   'Trace':{'CpuHz':N, 'Overrun':N,
+ *       'Tasks':['name1','name2',...],
+ *       'Events':[
+ *           [ts,type,id,arg],
+ *   ]}
+ */
+void TraceDriver::DumpAttribute::pre_read() {
+    int ena = fwtrace_enabled_;
+    int total;
+    FwTraceEvent *e;
+
+    fwtrace_enabled_ = 0;
+    total = fw_trace_get_count();
+    u_.u32 = static_cast<uint32_t>(total);
+
+    uart_printk("'Trace':{'CpuHz':%ld, 'Overrun':%ld,\r\n",
+                static_cast<int32_t>(SystemCoreClock),
+                static_cast<int32_t>(fw_trace_get_overrun()));
+    uart_printk("    'Tasks':[");
+    for (int i = 0; i < FWTRACE_TASKS_MAX; i++) {
+        uart_printk(i ? ",'%s'" : "'%s'", fw_trace_get_task_name(i));
+    }
+    uart_printk("],\r\n    'Events':[\r\n");
+    for (int i = 0; i < total; i++) {
+        e = fw_trace_get_event(i);
+        uart_printk("        [0x%08lx,%d,%d,%d],\r\n",
+                    e->ts, e->type, e->id, e->arg);
+    }
+    uart_printk("]}\r\n");
+    fwtrace_enabled_ = ena;
+}
@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+#include <fwlist.h>
+#include <fwobject.h>
+#include <FwAttribute.h>
+#include <fwtrace.h>
+
+/**
+ * @brief Control of the FreeRTOS event recorder (fwtrace.c). Reading of
+ *        'Dump' attribute prints the ring content as text into UART console
+ *        the same way as 'TargetConfig', qtmonitor converts it into Chrome
+ *        trace JSON file (chrome://tracing or ui.perfetto.dev).
+ */
+class TraceDriver : public FwObject {
+ public:
+    explicit TraceDriver(const char *name);
+
+    // FwObject interface:
+    virtual void Init() override;
+
+ protected:
+    class EnableAttribute : public FwAttribute {
+     public:
+        EnableAttribute(const char *name)
+            : FwAttribute(name, "1=start recording, 0=stop") {
+            make_uint8(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void post_write() override {
+            fw_trace_enable(u_.u8 ? 1 : 0);
+        }
+    };
+
+    class CountAttribute : public FwAttribute {
+     public:
+        CountAttribute(const char *name)
+            : FwAttribute(name, "Events in the ring buffer") {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override {
+            u_.u32 = static_cast<uint32_t>(fw_trace_get_count());
+        }
+    };
+
+    class OverrunAttribute : public FwAttribute {
+     public:
+        OverrunAttribute(const char *name)
+            : FwAttribute(name, "Overwritten events since start") {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override {
+            u_.u32 = fw_trace_get_overrun();
+        }
+    };
+
+    class DumpAttribute : public FwAttribute {
+     public:
+        DumpAttribute(const char *name)
+            : FwAttribute(name, "Read to print events into console") {
+            make_uint32(0);
+        }
+
+        virtual bool isPackable() override { return false; }
+        virtual void pre_read() override;
+    };
+
+ protected:
+    EnableAttribute enable_;
+    CountAttribute count_;
+    OverrunAttribute overrun_;
+    DumpAttribute dump_;
+};
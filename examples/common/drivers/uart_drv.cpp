@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwwait.h>
 #include <uart.h>
 #include <gpio_drv.h>
 #include <vprintfmt.h>
@@ -34,17 +35,42 @@ static const gpio_pin_type CFG_PIN_UART1_TX = {
     (GPIO_registers_type *)GPIOA_BASE, 9
 };
 
-static FwFifo *prxFifo_ = 0;
-static FwFifo *ptxFifo_ = 0;
+static FwRing *prxRing_ = 0;
+static FwRing *ptxRing_ = 0;
 static void *iraw_ = 0;
 
-extern "C" int uartdrv_putchar(int ch, void *putdat) {
+/** Full ring is drained in 22 ms at 115200 baud */
+#define UART_TX_TIMEOUT_US 50000
+
+/**
+ * @brief Push the next byte if the transmitter is idle (TXE interrupt may
+ *        be already handled). Called with disabled interrupts.
+ */
+static void uart_tx_kick(FwRing *ring) {
+    USART_registers_type *dev = (USART_registers_type *)USART1_BASE;
+    char tbyte;
+    // [7] TXE, transmit data register empty
+    if ((read16(&dev->SR) & (1 << 7)) && fw_ring_read(ring, &tbyte, 1)) {
+        write16(&dev->DR, static_cast<uint8_t>(tbyte));
+    }
+}
+
+static int uart_tx_space(void *arg) {
+    FwRing *ring = reinterpret_cast<FwRing *>(arg);
+    uint32_t primask = DisableIrqSave();
+    int ret;
+    uart_tx_kick(ring);
+    ret = !fw_ring_is_full(ring);
+    RestoreIrq(primask);
+    return ret;
+}
+
+extern "C" void uartdrv_putchar(int ch, void *putdat) {
     RawInterface *iraw = reinterpret_cast<RawInterface *>(putdat);
     char tbuf[4] = {static_cast<char>(ch), 0};
     if (iraw) {
         iraw->WriteData(tbuf, 1);
     }
-    return 0;
 }
 
 extern "C" void uart_printf(const char *fmt, ...) {
@@ -53,7 +79,7 @@ extern "C" void uart_printf(const char *fmt, ...) {
     }
     va_list ap;
     va_start(ap, fmt);
-    vprintfmt_lib((f_putch)uartdrv_putchar, iraw_, fmt, ap);
+    vprintfmt_lib(uartdrv_putchar, iraw_, fmt, ap);
     va_end(ap);
 }
 
@@ -61,12 +87,12 @@ extern "C" void uart_printf(const char *fmt, ...) {
 //
 extern "C" void USART1_irq_handler() {
     USART_registers_type *dev = (USART_registers_type *)USART1_BASE;
-    uint16_t rbyte;
+    char rbyte;
     char tbyte;
     while ((read16(&dev->SR) & (1 << 5)) != 0) {    // [5] RXNE: read data register not empty
-        rbyte = read16(&dev->DR);
-        if (prxFifo_) {
-            fw_fifo_put(prxFifo_, static_cast<char>(rbyte));
+        rbyte = static_cast<char>(read16(&dev->DR));
+        if (prxRing_) {
+            fw_ring_write(prxRing_, &rbyte, 1);
         }
     }
 
@@ -80,8 +106,7 @@ extern "C" void USART1_irq_handler() {
         // SR[7] TXE: {RO} is set. An interrupt is generated if TCIE=1 in the USART_CR1 register. It is cleared by
         // a software sequence (a read from the USART_SR register followed by a write to the
         // USART_DR register). 
-        if (ptxFifo_ && !fw_fifo_is_empty(ptxFifo_)) {
-            fw_fifo_get(ptxFifo_, &tbyte);
+        if (ptxRing_ && fw_ring_read(ptxRing_, &tbyte, 1)) {
             write16(&dev->DR, static_cast<uint16_t>(tbyte));
         } else {
             // clear TC (bit 6) and others RC_W0
@@ -145,11 +170,11 @@ UartDriver::UartDriver(const char *name)
 
     uart_early_init();
 
-    fw_fifo_init(&rxfifo_, 256);
-    prxFifo_ = &rxfifo_;
+    fw_ring_init(&rxring_, 1, 256);
+    prxRing_ = &rxring_;
 
-    fw_fifo_init(&txfifo_, 256);
-    ptxFifo_ = &txfifo_;
+    fw_ring_init(&txring_, 1, 256);
+    ptxRing_ = &txring_;
 }
 
 void UartDriver::Init() {
@@ -158,63 +183,45 @@ void UartDriver::Init() {
 
     // prio: 0 highest; 7 is lowest
     nvic_irq_enable(37, 3);
+
+    // uart_printk() from tasks goes through the Tx ring
+    uart_set_printk_writer(uartdrv_putchar, static_cast<RawInterface *>(this));
 }
 
 
 void UartDriver::callbackTimer(uint64_t tickcnt) {
     FwList *p = listener_;
     RawListenerInterface *iface;
-    char rxbyte;
 
 #ifdef x_WIN32
     if (tickcnt == 4000) {
         // [16,1] oil moisture
         const char *xxx = ">!00000110,1,01";  // read value
-        for (int i = 0; i < strlen(xxx); i++) {
-            fw_fifo_put(&rxfifo_, xxx[i]);
-        }
+        fw_ring_write(&rxring_, xxx, strlen(xxx));
     } else if (tickcnt == 5000) {
         // [17,1] rtc::Time set 20:59:00
         const char *xxx = ">!00000111,5,8100205900";
-        for (int i = 0; i < strlen(xxx); i++) {
-            fw_fifo_put(&rxfifo_, xxx[i]);
-        }
+        fw_ring_write(&rxring_, xxx, strlen(xxx));
     } else if (tickcnt == 5001) {
         // [10,3] hbrg0:dc0_duty enable=0x64(100) any non-zero value
         const char *xxx = ">!0000010B,2,8364";
-        for (int i = 0; i < strlen(xxx); i++) {
-            fw_fifo_put(&rxfifo_, xxx[i]);
-        }
+        fw_ring_write(&rxring_, xxx, strlen(xxx));
     } else if (tickcnt == 5002) {
         // [10,6] hbrg0:dc1_duty enable=0x64(100) any non-zero value
         const char *xxx = ">!0000010B,2,8664";
-        for (int i = 0; i < strlen(xxx); i++) {
-            fw_fifo_put(&rxfifo_, xxx[i]);
-        }
+        fw_ring_write(&rxring_, xxx, strlen(xxx));
     } else if (tickcnt == 5003) {
         // [8,0] uled0:state 2 blinking mode
         const char *xxx = ">!00000108,2,8002";
-        for (int i = 0; i < strlen(xxx); i++) {
-            fw_fifo_put(&rxfifo_, xxx[i]);
-        }
+        fw_ring_write(&rxring_, xxx, strlen(xxx));
     } else if (tickcnt == 5004) {
         // [2,0] relais0:state 1 enable
         const char *xxx = ">!00000102,2,8001";
-        for (int i = 0; i < strlen(xxx); i++) {
-            fw_fifo_put(&rxfifo_, xxx[i]);
-        }
+        fw_ring_write(&rxring_, xxx, strlen(xxx));
     }
 #endif
 
-    rxcnt_ = 0;
-    while (!fw_fifo_is_empty(&rxfifo_)) {
-        fw_fifo_get(&rxfifo_, &rxbyte);
-        if (rxcnt_ < sizeof(rxbuf_)) {
-            rxbuf_[rxcnt_++] = rxbyte;
-        } else {
-            break;
-        }
-    }
+    rxcnt_ = fw_ring_read(&rxring_, rxbuf_, sizeof(rxbuf_));
 
     p = listener_;
     while (p) {
@@ -225,23 +232,32 @@ void UartDriver::callbackTimer(uint64_t tickcnt) {
 }
 
 void UartDriver::WriteData(const char *buf, int sz) {
-    USART_registers_type *dev = (USART_registers_type *)USART1_BASE;
-    int was_empty = fw_fifo_is_empty(&txfifo_);
-    for (int i = 0; i < sz; i++) {
-        while (fw_fifo_is_full(&txfifo_)) {}
-        fw_fifo_put(&txfifo_, buf[i]);
-    }
+    uint32_t primask;
+    int wrcnt;
 
-    // [7] TXE, transmit data register empty
-    if (was_empty && (read16(&dev->SR) & (1 << 7))) {
-        char tbyte;
-        fw_fifo_get(&txfifo_, &tbyte);
-        write16(&dev->DR, static_cast<uint8_t>(tbyte));
-    }  
+    while (sz > 0) {
+        // Several tasks and interrupts print into the same ring, so the
+        // producer side is serialized. Copy as much as possible per pass
+        // and let the USART1 interrupt drain the ring when it is full.
+        primask = DisableIrqSave();
+        wrcnt = fw_ring_write(&txring_, buf, sz);
+        uart_tx_kick(&txring_);
+        RestoreIrq(primask);
+
+        buf += wrcnt;
+        sz -= wrcnt;
+        if (sz > 0) {
+            // Ring is full: tasks sleep while the interrupt drains it
+            fw_wait_poll(uart_tx_space, &txring_, UART_TX_TIMEOUT_US);
+        }
+    }
 }
 
 void UartDriver::RegisterRawListener(RawListenerInterface *iface) {
     FwList *item = reinterpret_cast<FwList *>(fw_malloc(sizeof(FwList)));
+    if (item == 0) {
+        return;
+    }
     fwlist_set_payload(item, iface);
     fwlist_add(&listener_, item);
 }
@@ -18,7 +18,7 @@
 #include <prjtypes.h>
 #include <fwlist.h>
 #include <fwobject.h>
-#include <fwfifo.h>
+#include <fwring.h>
 #include <FwAttribute.h>
 #include <TimerInterface.h>
 #include <RawInterface.h>
@@ -33,8 +33,9 @@ class UartDriver : public FwObject,
     virtual void Init() override;
 
     // TimerListenerInterface
-    virtual uint64_t getTimerInterval() override { return 1; }
+    virtual uint64_t getTimerInterval() override { return 10; }
     virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_COMMS; }
 
     // RawInterface
     virtual void WriteData(const char *buf, int sz) override;
@@ -43,8 +44,8 @@ class UartDriver : public FwObject,
  protected:
     FwList *listener_;
 
-    FwFifo rxfifo_;
-    FwFifo txfifo_;
+    FwRing rxring_;
+    FwRing txring_;
     char rxbuf_[32];
     int rxcnt_;
 };
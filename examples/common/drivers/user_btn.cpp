@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <mcu.h>
 #include <fwapi.h>
+#include <fwirq.h>
 #include <uart.h>
 #include <gpio_drv.h>
 #include "user_btn.h"
@@ -31,12 +32,13 @@ static const gpio_pin_type ubtn_pin = {
 // EXTI15_10
 extern "C" void Btn_IRQHandler() {
     EXTI_registers_type *EXTI = (EXTI_registers_type *)EXTI_BASE;
+    int state;
 
-    IrqHandlerInterface *iface = reinterpret_cast<IrqHandlerInterface *>(
-            fw_get_object_interface("ubtn0", "IrqHandlerInterface"));
-    if (iface) {
-        int state = static_cast<int>(gpio_pin_get(&ubtn_pin));
-        iface->handleInterrupt(&state);
+    if ((read32(&EXTI->PR) & (1 << ubtn_pin.pinidx)) == 0) {
+        fw_irq_spurious(40);
+    } else {
+        state = static_cast<int>(gpio_pin_get(&ubtn_pin));
+        fw_irq_dispatch(40, &state);
     }
 
     write32(&EXTI->PR, 1 << ubtn_pin.pinidx);   // Pending register, cleared by programming it to 1
@@ -85,6 +87,7 @@ void UserButtonDriver::Init() {
     RegisterInterface(static_cast<IrqHandlerInterface *>(this));
     RegisterInterface(static_cast<TimerListenerInterface *>(this));
     RegisterInterface(static_cast<KeyInterface *>(this));
+    fw_irq_bind(40, static_cast<IrqHandlerInterface *>(this));
 
     // prio: 0 highest; 7 is lowest
     nvic_irq_enable(40, 3);
@@ -114,6 +117,9 @@ void UserButtonDriver::handleInterrupt(int *state) {
 
 void UserButtonDriver::registerKeyListener(KeyListenerInterface *iface) {
     FwList *item = reinterpret_cast<FwList *>(fw_malloc(sizeof(FwList)));
+    if (item == 0) {
+        return;
+    }
     fwlist_set_payload(item, iface);
     fwlist_add(&listener_, item);
 }
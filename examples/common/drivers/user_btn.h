@@ -43,7 +43,7 @@ class UserButtonDriver : public FwObject,
     virtual void handleInterrupt(int *argv) override;
 
     // TimerListenerInterface
-    virtual uint64_t getTimerInterval() override { return 1; }
+    virtual uint64_t getTimerInterval() override { return 10; }
     virtual void callbackTimer(uint64_t tickcnt) override;
 
     // KeyInterface
@@ -41,6 +41,7 @@ class UserLedDriver : public FwObject,
     // TimerListenerInterface
     virtual uint64_t getTimerInterval() override;
     virtual void callbackTimer(uint64_t tickcnt) override;
+    virtual int getExecClass() override { return FW_EXEC_BACKGROUND; }
 
  protected:
     FwAttribute state_;
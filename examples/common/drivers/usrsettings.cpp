@@ -20,30 +20,17 @@
 #include "usrsettings.h"
 #include <uart.h>
 
-UserSettings::UserSettings(const char *name) : FwObject(name),
-    lastServiceDate_("LastServiceDate", "rtc date"),
-    lastServiceTime_("LastServiceTime", "rtc time"),
-    requestToService_("RequestToService"),
-    wateringPerDrain_("WateringPerDrain", "0..n counts"),
-    wateringInterval_("WateringInterval", "[sec]"),
-    wateringDuration_("WateringDuration", "[sec]"),
-    lastWatering_("LastWatering", "rtc time"),
-    oxygenSaturationInterval_("OxygenSaturationInterval", "[sec]"),
-    dayStart_("DayStart", "[sec] time of day"),
-    dayEnd_("DayEnd", "[sec] time of day"),
-    dayDuty0_("DayDuty0", "pwm: 0..100 (blue)"),
-    dayDuty1_("DayDuty1", "pwm: 0..100 (ventilation)"),
-    dayDuty2_("DayDuty2", "pwm: 0..100 (white)"),
-    dayDuty3_("DayDuty3", "pwm: 0..100 (red/blue)"),
-    state_("State", "Management task state: "
-        "0=WaitInit, "
-        "1=CheckWateringInterval, "
-        "2=DrainBefore, "
-        "3=OxygenSaturation, "
-        "4=Watering, "
-        "5=DrainAfter, "
-        "6=AdjustLights, "
-        "7=Servicing") {
+#define USER_SETTINGS_ENTRY(type, member, name, ...) \
+    FW_STATIC_ENTRY(UserSettings, member, name),
+
+FW_STATIC_TABLE_BEGIN
+const FwStaticEntry UserSettings::ATTRIBUTES[] = {
+    USER_SETTINGS_ATTRIBUTES(USER_SETTINGS_ENTRY)
+};
+FW_STATIC_TABLE_END
+
+UserSettings::UserSettings(const char *name) : FwObject(name)
+    USER_SETTINGS_ATTRIBUTES(FW_STATIC_INIT) {
 
     lastServiceDate_.make_uint32(0);
     lastServiceTime_.make_uint32(0);
@@ -60,23 +47,10 @@ UserSettings::UserSettings(const char *name) : FwObject(name),
     dayDuty2_.make_int8(0);        // white
     dayDuty3_.make_int8(10);        // red
     state_.make_int8(0);
+    SetStaticAttributes(ATTRIBUTES, FW_STATIC_TABLE_SIZE(ATTRIBUTES));
 }
 
 void UserSettings::Init() {
-    RegisterAttribute(&lastServiceTime_);
-    RegisterAttribute(&lastServiceDate_);
-    RegisterAttribute(&requestToService_);
-    RegisterAttribute(&wateringPerDrain_);
-    RegisterAttribute(&wateringInterval_);
-    RegisterAttribute(&wateringDuration_);
-    RegisterAttribute(&lastWatering_);
-    RegisterAttribute(&oxygenSaturationInterval_);
-    RegisterAttribute(&dayStart_);
-    RegisterAttribute(&dayEnd_);
-    RegisterAttribute(&dayDuty0_);
-    RegisterAttribute(&dayDuty1_);
-    RegisterAttribute(&dayDuty2_);
-    RegisterAttribute(&dayDuty3_);
-    RegisterAttribute(&state_);
+    // Attributes are described by the static table
 }
 
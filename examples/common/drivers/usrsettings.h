@@ -21,6 +21,35 @@
 #include <fwobject.h>
 #include <FwAttribute.h>
 
+/**
+ * @brief Attributes in DBC index order, see FW_STATIC_MEMBER()
+ */
+#define USER_SETTINGS_ATTRIBUTES(X) \
+    X(FwAttribute, lastServiceTime_, "LastServiceTime", "rtc time") \
+    X(FwAttribute, lastServiceDate_, "LastServiceDate", "rtc date") \
+    X(FwAttribute, requestToService_, "RequestToService") \
+    X(FwAttribute, wateringPerDrain_, "WateringPerDrain", "0..n counts") \
+    X(FwAttribute, wateringInterval_, "WateringInterval", "[sec]") \
+    X(FwAttribute, wateringDuration_, "WateringDuration", "[sec]") \
+    X(FwAttribute, lastWatering_, "LastWatering", "rtc time") \
+    X(FwAttribute, oxygenSaturationInterval_, "OxygenSaturationInterval", \
+      "[sec]") \
+    X(FwAttribute, dayStart_, "DayStart", "[sec] time of day") \
+    X(FwAttribute, dayEnd_, "DayEnd", "[sec] time of day") \
+    X(FwAttribute, dayDuty0_, "DayDuty0", "pwm: 0..100 (blue)") \
+    X(FwAttribute, dayDuty1_, "DayDuty1", "pwm: 0..100 (ventilation)") \
+    X(FwAttribute, dayDuty2_, "DayDuty2", "pwm: 0..100 (white)") \
+    X(FwAttribute, dayDuty3_, "DayDuty3", "pwm: 0..100 (red/blue)") \
+    X(FwAttribute, state_, "State", "Management task state: " \
+        "0=WaitInit, " \
+        "1=CheckWateringInterval, " \
+        "2=DrainBefore, " \
+        "3=OxygenSaturation, " \
+        "4=Watering, " \
+        "5=DrainAfter, " \
+        "6=AdjustLights, " \
+        "7=Servicing")
+
 class UserSettings : public FwObject {
  public:
     explicit UserSettings(const char *name);
@@ -31,19 +60,8 @@ class UserSettings : public FwObject {
  protected:
 
  protected:
-    FwAttribute lastServiceDate_;
-    FwAttribute lastServiceTime_;
-    FwAttribute requestToService_;
-    FwAttribute wateringPerDrain_;
-    FwAttribute wateringInterval_;
-    FwAttribute wateringDuration_;
-    FwAttribute lastWatering_;
-    FwAttribute oxygenSaturationInterval_;
-    FwAttribute dayStart_;
-    FwAttribute dayEnd_;
-    FwAttribute dayDuty0_;
-    FwAttribute dayDuty1_;
-    FwAttribute dayDuty2_;
-    FwAttribute dayDuty3_;
-    FwAttribute state_;
+    USER_SETTINGS_ATTRIBUTES(FW_STATIC_MEMBER)
+
+ private:
+    static const FwStaticEntry ATTRIBUTES[];
 };
@@ -18,42 +18,118 @@
 #include <fwobject.h>
 #include <RawInterface.h>
 #include <fwapi.h>
+#include <fwclock.h>
 #include <string.h>
 #include <stdio.h>
 #include <uart.h>
 
 FwList *objlist_ = 0;
+FwHashTable objtbl_ = {0, 0, 0};
+// Dense array of run-time objects in the same order as objlist_
+FwObject **objarr_ = 0;
+int objcnt_ = 0;
+int objmax_ = 0;
+
+// Flash resident table of the kernel members
+static char *static_base_ = 0;
+static int static_size_ = 0;
+static const FwStaticEntry *static_tbl_ = 0;
+static int static_cnt_ = 0;
+static int static_constructed_ = 0;
+
+static int match_object(void *payload, const void *key) {
+    FwObject *obj = reinterpret_cast<FwObject *>(payload);
+    return strcmp(obj->ObjectName(), reinterpret_cast<const char *>(key)) == 0;
+}
+
+static FwObject *static_object(int idx) {
+    return reinterpret_cast<FwObject *>(static_base_ + static_tbl_[idx].offset);
+}
 
 extern "C" void kernel_init();   // Must be defined on application level
 
 extern "C" void fw_init() {
-    FwList *p;
-    FwObject *obj;
+    int i;
 
     fw_malloc_init();
+    fw_clock_init();
 
     kernel_init();
 
     // It is possible to create JSON-configration file and platform loading here
-    p = fw_get_objects_list();
-    while (p) {
-        obj = reinterpret_cast<FwObject *>(fwlist_get_payload(p));
-        obj->Init();
-        p = p->next;
+    for (i = 0; i < fw_get_objects_count(); i++) {
+        reinterpret_cast<FwObject *>(fw_get_obj_by_index(i))->Init();
     }
 
-    p = fw_get_objects_list();
-    while (p) {
+    // All attributes are registered in Init() stage, build hash tables
+    // before PostInit() where interfaces are requested by name
+    fw_seal_registry();
+
+    for (i = 0; i < fw_get_objects_count(); i++) {
+        reinterpret_cast<FwObject *>(fw_get_obj_by_index(i))->PostInit();
+    }
+}
+
+/**
+ * @brief Build hash tables of registered objects and their attributes
+ *        and interfaces. Objects of the static table are added into the
+ *        same hash table, the flash table is scanned only before seal.
+ */
+extern "C" void fw_seal_registry() {
+    FwList *p;
+    FwObject *obj;
+    int cnt = 0;
+
+    if (static_constructed_ != static_cnt_) {
+        uart_printf("static objects table %d != %d\r\n",
+                    static_cnt_, static_constructed_);
+    }
+    for (int i = 0; i < static_cnt_; i++) {
+        obj = static_object(i);
+        if (obj->ObjectHash() != static_tbl_[i].hash) {
+            uart_printf("static object %s hash mismatch\r\n", obj->ObjectName());
+        }
+        obj->Seal();
+    }
+
+    for (p = fw_get_objects_list(); p; p = p->next) {
+        cnt++;
+    }
+    fw_hash_table_init(&objtbl_, static_cnt_ + cnt);
+    for (int i = 0; i < static_cnt_; i++) {
+        fw_hash_table_add(&objtbl_, static_tbl_[i].hash, static_object(i));
+    }
+    objarr_ = reinterpret_cast<FwObject **>(fw_mem_alloc(cnt * sizeof(FwObject *)));
+    if (objarr_) {
+        objmax_ = cnt;
+    }
+
+    for (p = fw_get_objects_list(); p; p = p->next) {
         obj = reinterpret_cast<FwObject *>(fwlist_get_payload(p));
-        obj->PostInit();
-        p = p->next;
+        obj->Seal();
+        fw_hash_table_add(&objtbl_, obj->ObjectHash(), obj);
+        if (objarr_) {
+            objarr_[objcnt_++] = obj;
+        }
     }
 }
 
+extern "C" void fw_register_static_objects(void *parent,
+                                           int size,
+                                           const FwStaticEntry *tbl,
+                                           int cnt) {
+    static_base_ = reinterpret_cast<char *>(parent);
+    static_size_ = size;
+    static_tbl_ = tbl;
+    static_cnt_ = cnt;
+}
+
 extern "C" FwList *fw_empty_list_item() {
     FwList *ret = (FwList *)fw_malloc(sizeof(FwList));
 
-    fwlist_set_payload(ret, 0);
+    if (ret) {
+        fwlist_set_payload(ret, 0);
+    }
     return ret;
 }
 
@@ -61,24 +137,72 @@ extern "C" FwList *fw_empty_list_item() {
  * @brief register new FwObject casted tp CommonInterface
  * @param[in] obj Pointer that should be registered in the linked list of
  *                objects.
- * @todo Implement alphabetically sorted list to improve list search
  */
 extern "C" void fw_register_object(void *obj) {
+    char *addr = reinterpret_cast<char *>(obj);
+    if (addr >= static_base_ && addr < static_base_ + static_size_) {
+        // Member of the kernel described by the static table
+        static_constructed_++;
+        return;
+    }
+
     FwList *p = fw_empty_list_item();
-    
+    if (p == 0) {
+        return;
+    }
+
     fwlist_set_payload(p, obj);
     fwlist_add(&objlist_, p);
+
+    if (fw_hash_table_is_ready(&objtbl_)) {
+        // Object created after registry was sealed. Its attributes are
+        // registered later and will be added into the object's tables.
+        FwObject *o = reinterpret_cast<FwObject *>(obj);
+        o->Seal();
+        fw_hash_table_add(&objtbl_, o->ObjectHash(), o);
+        if (objarr_ == 0) {
+            // Dense array wasn't allocated, lookups walk the list
+            return;
+        }
+        if (objcnt_ == objmax_) {
+            FwObject **old = objarr_;
+            FwObject **arr = reinterpret_cast<FwObject **>(
+                    fw_mem_alloc((2 * objmax_ + 1) * sizeof(FwObject *)));
+            if (arr == 0) {
+                return;
+            }
+            for (int i = 0; i < objcnt_; i++) {
+                arr[i] = old[i];
+            }
+            objarr_ = arr;
+            objmax_ = 2 * objmax_ + 1;
+            fw_mem_free(old);
+        }
+        objarr_[objcnt_++] = o;
+    }
 }
 
 /**
- * @brief Get single linked list of all registered objects
- * @return Pointer to list of regsitered objects. At least one should be
- *         presence as Kernel object.
+ * @brief Get single linked list of objects registered in run-time
+ * @return Pointer to list of regsitered objects.
  */
 extern "C" FwList *fw_get_objects_list() {
     return objlist_;
 }
 
+extern "C" int fw_get_objects_count() {
+    int ret = static_cnt_;
+    FwList *p = objlist_;
+    if (objarr_) {
+        return ret + objcnt_;
+    }
+    while (p) {
+        ret++;
+        p = p->next;
+    }
+    return ret;
+}
+
 /**
  * @brief Get pointer to FwObject by its name.
  * @param[i] name Object name string used as the FwObject identificator.
@@ -86,8 +210,21 @@ extern "C" FwList *fw_get_objects_list() {
  *         the object not found
  */
 extern "C" void *fw_get_object(const char *name) {
-    FwObject *obj;
+    FwObject *obj = 0;
     FwList *p = fw_get_objects_list();
+    uint32_t hash = fw_hash(name);
+    if (fw_hash_table_is_ready(&objtbl_)) {
+        return fw_hash_table_find(&objtbl_, hash, name, match_object);
+    }
+    for (int i = 0; i < static_cnt_; i++) {
+        if (static_tbl_[i].hash == hash) {
+            obj = static_object(i);
+            if (strcmp(obj->ObjectName(), name) == 0) {
+                return obj;
+            }
+        }
+    }
+    obj = 0;
     while (p) {
         obj = reinterpret_cast<FwObject *>(fwlist_get_payload(p));
         p = p->next;
@@ -166,6 +303,16 @@ extern "C" void *fw_get_obj_by_index(int obj_idx) {
     int tcnt = 0;
     FwList *pitem = fw_get_objects_list();
     FwObject *ret = 0;
+    if (obj_idx >= 0 && obj_idx < static_cnt_) {
+        return static_object(obj_idx);
+    }
+    obj_idx -= static_cnt_;
+    if (objarr_) {
+        if (obj_idx < 0 || obj_idx >= objcnt_) {
+            return 0;
+        }
+        return objarr_[obj_idx];
+    }
     // Find object with the specified index
     while (pitem != 0 && tcnt != obj_idx) {
         pitem = pitem->next;
@@ -179,18 +326,7 @@ extern "C" void *fw_get_obj_by_index(int obj_idx) {
 }
 
 extern "C" void *fw_get_obj_attr_by_name(void *obj, const char *atrname) {
-    FwAttribute *attr = 0;
-    FwList *pitem = reinterpret_cast<FwObject *>(obj)->GetAttributes();
-    // Find object with the specified index
-    while (pitem) {
-        attr = reinterpret_cast<FwAttribute *>(fwlist_get_payload(pitem));
-        if (strcmp(attr->name(), atrname) == 0) {
-            return attr;
-        }
-        pitem = pitem->next;
-    }
-
-    return 0;
+    return reinterpret_cast<FwObject *>(obj)->GetAttribute(atrname);
 }
 
 /**
@@ -203,18 +339,5 @@ extern "C" void *fw_get_obj_attr_by_name(void *obj, const char *atrname) {
  */
 extern "C" void *fw_get_obj_attr_by_index(void *obj,
                                       int atr_idx) {
-    int tcnt = 0;
-    FwList *pitem = reinterpret_cast<FwObject *>(obj)->GetAttributes();
-    void *ret = 0;
-    // Find object with the specified index
-    while (pitem != 0 && tcnt != atr_idx) {
-        pitem = pitem->next;
-        tcnt++;
-    }
-
-    if (pitem != 0 && tcnt == atr_idx) {
-        ret = fwlist_get_payload(pitem);
-    }
-    return ret;
+    return reinterpret_cast<FwObject *>(obj)->GetAttributeByIndex(atr_idx);
 }
-
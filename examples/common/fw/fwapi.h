@@ -18,6 +18,7 @@
 
 #include <inttypes.h>
 #include <fwlist.h>
+#include <fwstatic.h>
 #include <stdarg.h>
 
 #ifdef __cplusplus
@@ -28,19 +29,80 @@ extern "C" {
  */
 void fw_init();
 
+/**
+ * @brief Build hash tables of all registered objects, attributes and
+ *        interfaces. Called by fw_init() after objects initialization.
+ *        Objects registered after this call are added into the tables
+ *        on the fly.
+ */
+void fw_seal_registry();
+
 void fw_malloc_init();
 
+/**
+ * @brief Allocate memory for init-time objects. Memory is taken from the
+ *        arena placed between .bss and the main stack, aligned to 8 bytes
+ *        and never released.
+ * @param[in] size Size in bytes
+ * @return Pointer to allocated memory or zero when arena reaches stack limit
+ */
 void *fw_malloc(int size);
 
+/**
+ * @brief Allocate memory block with O(1) complexity that can be released
+ *        by fw_mem_free(). Blocks up to 1024 bytes are taken from fixed
+ *        size pools (16, 32, .., 1024 bytes), larger blocks from the best
+ *        fit free large block or from arena. Safe to call from ISR.
+ * @param[in] size Size in bytes
+ * @return Pointer to allocated block or zero if no memory left
+ */
+void *fw_mem_alloc(int size);
+
+/**
+ * @brief Release block allocated by fw_mem_alloc(). Safe to call from ISR.
+ * @param[in] ptr Pointer to block returned by fw_mem_alloc()
+ */
+void fw_mem_free(void *ptr);
+
+/**
+ * @brief Bytes available for allocation: arena, pools and large blocks
+ *        free lists
+ */
+uint32_t fw_mem_get_free_size();
+
+/**
+ * @brief Minimum ever value of fw_mem_get_free_size()
+ */
+uint32_t fw_mem_get_min_free_size();
+
+/**
+ * @brief Bytes allocated from arena
+ */
+uint32_t fw_mem_get_allocated_size();
+
+/**
+ * @brief Bytes in the free large blocks that are not on top of arena
+ */
+uint32_t fw_mem_get_large_free_size();
+
+/**
+ * @brief Number of failed allocations, the allocator never prints anything
+ *        so it can be linked without uart
+ */
+uint32_t fw_mem_get_overflow_count();
+
+/**
+ * @brief Number of fw_mem_free() calls with a wrong or released pointer
+ */
+uint32_t fw_mem_get_invalid_free_count();
+
 void fw_register_ram_data(const char *name, void *data);
 
 void *fw_get_ram_data(const char *name);
 
 /**
- * @brief Get pointer to an empty FwList element. FW allocates items
- *        from the static array of the fixed size and check that number
- *        allocated items do not exceed maximum value.
- * @return Pointer to an empty list item.
+ * @brief Get pointer to an empty FwList element allocated by fw_malloc().
+ * @return Pointer to an empty list item or zero when arena is exhausted.
  */
 FwList *fw_empty_list_item();
 
@@ -51,12 +113,34 @@ FwList *fw_empty_list_item();
 void fw_register_object(void *obj);
 
 /**
- * @brief Get single linked list of all registered objects
- * @return Pointer to list of regsitered objects. At least one should be
- *         presence as Kernel object.
+ * @brief Register flash resident table of objects that are members of the
+ *        parent (kernel) class. Should be called before the parent
+ *        constructor so that FwObject constructors of the members do not
+ *        allocate list items. These objects get the first indexes in the
+ *        table order.
+ * @param[in] parent Pointer to the memory where parent class is constructed
+ * @param[in] size Size of the parent class in bytes
+ * @param[in] tbl Pointer to the static table
+ * @param[in] cnt Number of entries in the table
+ */
+void fw_register_static_objects(void *parent,
+                                int size,
+                                const FwStaticEntry *tbl,
+                                int cnt);
+
+/**
+ * @brief Get single linked list of objects registered in run-time, objects
+ *        of the static table aren't included.
+ * @return Pointer to list of regsitered objects.
  */
 FwList *fw_get_objects_list();
 
+/**
+ * @brief Get total number of registered objects (static and run-time).
+ *        Use it with fw_get_obj_by_index() to iterate all objects.
+ */
+int fw_get_objects_count();
+
 /**
  * @brief Get pointer to FwObject by its name.
  * @param[i] name Object name string used as the FwObject identificator.
@@ -14,8 +14,12 @@
  *  limitations under the License.
  */
 
+#include <prjtypes.h>
 #include <fwattribute.h>
 #include <fwobject.h>
+#include <fwapi.h>
+#include <FreeRTOS.h>
+#include <task.h>
 
 FwAttribute::FwAttribute(const char *name, const char *descr) :
     CommonInterface("FwAttribute") {
@@ -23,6 +27,7 @@ FwAttribute::FwAttribute(const char *name, const char *descr) :
     name_ = name;
     jsonDescription_ = descr;
     u_.u64 = 0;
+    subscribers_ = 0;
 }
 
 /**
@@ -31,7 +36,7 @@ FwAttribute::FwAttribute(const char *name, const char *descr) :
 void FwAttribute::make_nil() {
     kind_ = Attr_Nil;
     u_.u64 = 0;
-    post_write();
+    changed();
 }
 
 /**
@@ -41,7 +46,7 @@ void FwAttribute::make_nil() {
 void FwAttribute::make_string(const char *v) {
     kind_ = Attr_String;
     u_.string = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -61,7 +66,7 @@ const char *FwAttribute::to_string() {
 void FwAttribute::make_int8(int8_t v) {
     kind_ = Attr_Int8;
     u_.i8 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -80,7 +85,7 @@ int8_t FwAttribute::to_int8() {
 void FwAttribute::make_uint8(uint8_t v) {
     kind_ = Attr_UInt8;
     u_.u8 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -99,7 +104,7 @@ uint8_t FwAttribute::to_uint8() {
 void FwAttribute::make_int16(int16_t v) {
     kind_ = Attr_Int16;
     u_.i16 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -118,7 +123,7 @@ int16_t FwAttribute::to_int16() {
 void FwAttribute::make_uint16(uint16_t v) {
     kind_ = Attr_UInt16;
     u_.u16 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -137,7 +142,7 @@ uint16_t FwAttribute::to_uint16() {
 void FwAttribute::make_int32(int32_t v) {
     kind_ = Attr_Int32;
     u_.i32 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -156,7 +161,7 @@ int32_t FwAttribute::to_int32() {
 void FwAttribute::make_uint32(uint32_t v) {
     kind_ = Attr_UInt32;
     u_.u32 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -175,7 +180,7 @@ uint32_t FwAttribute::to_uint32() {
 void FwAttribute::make_int64(int64_t v) {
     kind_ = Attr_Int64;
     u_.i64 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -194,7 +199,7 @@ int64_t FwAttribute::to_int64() {
 void FwAttribute::make_uint64(uint64_t v) {
     kind_ = Attr_UInt64;
     u_.u64 = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -213,7 +218,7 @@ uint64_t FwAttribute::to_uint64() {
 void FwAttribute::make_float(float v) {
     kind_ = Attr_Float;
     u_.f = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -232,7 +237,7 @@ float FwAttribute::to_float() {
 void FwAttribute::make_double(double v) {
     kind_ = Attr_Double;
     u_.d = v;
-    post_write();
+    changed();
 }
 
 /**
@@ -260,7 +265,7 @@ void FwAttribute::write(char *buf, int sz, bool silence) {
     for (int i = 0; i < sz; i++) {
         u_.data[i & 0x7] = buf[i];
     }
-    post_write();
+    changed();
 
     if (!silence) {
         // Send to external interface (CAN, UART) attribute was updated
@@ -309,3 +314,124 @@ int FwAttribute::BitSize() {
     }
     return ret;
 }
+
+void FwAttribute::registerListener(AttributeListenerInterface *iface,
+                                   float deadband,
+                                   uint32_t interval_ms) {
+    FwAttrSubscriber *p;
+    uint32_t primask;
+
+    // Reuse removed item, the list is modified only with disabled irq
+    primask = DisableIrqSave();
+    for (p = subscribers_; p; p = p->next) {
+        if (p->iface == 0) {
+            initSubscriber(p, deadband, interval_ms);
+            data_memory_barrier();
+            p->iface = iface;
+            RestoreIrq(primask);
+            return;
+        }
+    }
+    RestoreIrq(primask);
+
+    p = reinterpret_cast<FwAttrSubscriber *>(
+                fw_mem_alloc(sizeof(FwAttrSubscriber)));
+    if (p == 0) {
+        return;
+    }
+    initSubscriber(p, deadband, interval_ms);
+    p->iface = iface;
+
+    primask = DisableIrqSave();
+    p->next = subscribers_;
+    // Item should be completed before it becomes visible for ISR
+    data_memory_barrier();
+    subscribers_ = p;
+    RestoreIrq(primask);
+}
+
+void FwAttribute::initSubscriber(FwAttrSubscriber *p,
+                                 float deadband,
+                                 uint32_t interval_ms) {
+    p->deadband = deadband;
+    p->last_value = to_numeric();
+    p->interval = pdMS_TO_TICKS(interval_ms);
+    p->last_time = xTaskGetTickCount() - p->interval;
+}
+
+void FwAttribute::unregisterListener(AttributeListenerInterface *iface) {
+    uint32_t primask = DisableIrqSave();
+    for (FwAttrSubscriber *p = subscribers_; p; p = p->next) {
+        if (p->iface == iface) {
+            // Not freed: notify() could be preempted on this item
+            p->iface = 0;
+            break;
+        }
+    }
+    RestoreIrq(primask);
+}
+
+float FwAttribute::to_numeric() {
+    switch (kind_) {
+    case Attr_Int8:
+        return static_cast<float>(u_.i8);
+    case Attr_UInt8:
+        return static_cast<float>(u_.u8);
+    case Attr_Int16:
+        return static_cast<float>(u_.i16);
+    case Attr_UInt16:
+        return static_cast<float>(u_.u16);
+    case Attr_Int32:
+        return static_cast<float>(u_.i32);
+    case Attr_UInt32:
+        return static_cast<float>(u_.u32);
+    case Attr_Int64:
+        return static_cast<float>(u_.i64);
+    case Attr_UInt64:
+        return static_cast<float>(u_.u64);
+    case Attr_Float:
+        return u_.f;
+    case Attr_Double:
+        return static_cast<float>(u_.d);
+    default:;
+    }
+    return 0;
+}
+
+void FwAttribute::notify() {
+    FwAttrSubscriber *p = subscribers_;
+    AttributeListenerInterface *iface;
+    uint32_t tnow;
+    float v = 0;
+    float dlt;
+
+    if (IsInsideIrq()) {
+        tnow = xTaskGetTickCountFromISR();
+    } else {
+        tnow = xTaskGetTickCount();
+    }
+
+    while (p) {
+        iface = p->iface;
+        if (iface == 0
+            || (p->interval && (tnow - p->last_time) < p->interval)) {
+            p = p->next;
+            continue;
+        }
+        if (p->deadband != 0) {
+            v = to_numeric();
+            dlt = v - p->last_value;
+            if (dlt < 0) {
+                dlt = -dlt;
+            }
+            if (dlt < p->deadband) {
+                p = p->next;
+                continue;
+            }
+            p->last_value = v;
+        }
+        p->last_time = tnow;
+        iface->attributeChanged(this);
+        p = p->next;
+    }
+}
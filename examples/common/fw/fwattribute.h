@@ -18,6 +18,7 @@
 
 #include <inttypes.h>
 #include <CommonInterface.h>
+#include <AttributeInterface.h>
 
 /**
  * @brief FwAttribute types as enum. Attribute should provide safe conversion
@@ -66,6 +67,22 @@ static const char *KindTypeString[Attr_PyObject + 1] = {
     "pyobject",
 };
 
+/**
+ * @brief Listener subscribed on the attribute modification. Items are
+ *        allocated only by registerListener() so that attribute without
+ *        subscribers has only zero pointer. Items are never freed: notify()
+ *        walks the list without lock, so the removed item only gets zero
+ *        iface and is reused by the next registerListener().
+ */
+typedef struct FwAttrSubscriber {
+    struct FwAttrSubscriber *next;
+    AttributeListenerInterface *iface;
+    float deadband;         // minimal absolute change, 0 = any write
+    float last_value;       // value sent in the last notification
+    uint32_t interval;      // minimal time between notifications in ticks
+    uint32_t last_time;     // tick of the last notification
+} FwAttrSubscriber;
+
 /**
  * @brief FwAttribute declaration. All FwAttribute instance should have
  *        string identificator and optional description in JSON-format
@@ -277,6 +294,43 @@ class FwAttribute : public CommonInterface {
     virtual void pre_read() {}
     virtual void post_write() {}
 
+    /**
+     * @brief Attribute could be placed into the packed DBC page, that is
+     *        read and written as a whole. Non-numeric and attributes with the
+     *        pre_read()/post_write() hooks are accessible only by the
+     *        single attribute multiplexor, so the hooks run only on demand.
+     *        Every class overriding the hooks also overrides this method.
+     */
+    virtual bool isPackable() {
+        return kind_ >= Attr_Int8 && kind_ <= Attr_Double;
+    }
+
+    /**
+     * @brief Subscribe on the attribute modification. Listener is called
+     *        after post_write() from any make_*(), write() or
+     *        TypedAttribute::set() call, including interrupt handlers.
+     * @param[in] iface Listener interface
+     * @param[in] deadband Notify only if the numeric value changed at least
+     *                     on this value since the last notification.
+     *                     0 means notify on each write.
+     * @param[in] interval_ms Minimal interval between notifications. Writes
+     *                     inside of this interval are not reported.
+     */
+    void registerListener(AttributeListenerInterface *iface,
+                          float deadband = 0,
+                          uint32_t interval_ms = 0);
+
+    /**
+     * @brief Remove subscription. Should not be called from ISR. notify()
+     *        that is already running could call the listener once more.
+     */
+    void unregisterListener(AttributeListenerInterface *iface);
+
+    /**
+     * @brief Get numeric value of any kind as float, used for deadband check
+     */
+    float to_numeric();
+
     /**
      * @brief Detect number of bits need to represent attribute in DBC message
      * @return Number of bits need to represent attribute
@@ -300,6 +354,23 @@ class FwAttribute : public CommonInterface {
 
 
 
+ protected:
+    /** Call post_write() hook and notify subscribers if any */
+    void changed() {
+        post_write();
+        if (subscribers_) {
+            notify();
+        }
+    }
+
+    /** Notify subscribers with deadband and interval filtering */
+    void notify();
+
+    /** Fill filtering fields of new or reused subscriber */
+    void initSubscriber(FwAttrSubscriber *p,
+                        float deadband,
+                        uint32_t interval_ms);
+
  protected:
     /** Union to safly convert data buffer into specified value type */
     union
@@ -323,4 +394,6 @@ class FwAttribute : public CommonInterface {
     const char *jsonDescription_;
     /** Attribute type */
     EKindType kind_;
+    /** List of subscribed listeners, zero if nobody subscribed */
+    FwAttrSubscriber *subscribers_;
 };
@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <fwattribute.h>
+
+/**
+ * @brief Deliver attribute notifications into the FreeRTOS queue of
+ *        FwAttribute pointers. Notification is dropped if the queue is full.
+ *
+ *   Example:
+ *        QueueHandle_t q = xQueueCreate(4, sizeof(FwAttribute *));
+ *        FwAttrQueueListener *l = new (fw_malloc(...)) FwAttrQueueListener(q);
+ *        attr->registerListener(l, 1.0f);
+ *        ...
+ *        FwAttribute *changed;
+ *        xQueueReceive(q, &changed, portMAX_DELAY);
+ */
+class FwAttrQueueListener : public AttributeListenerInterface {
+ public:
+    explicit FwAttrQueueListener(QueueHandle_t queue) : queue_(queue) {}
+
+    virtual void attributeChanged(FwAttribute *attr) override {
+        BaseType_t woken = pdFALSE;
+        if (IsInsideIrq()) {
+            xQueueSendFromISR(queue_, &attr, &woken);
+            portYIELD_FROM_ISR(woken);
+        } else {
+            xQueueSend(queue_, &attr, 0);
+        }
+    }
+
+ protected:
+    QueueHandle_t queue_;
+};
+
+/**
+ * @brief Deliver attribute notifications as the task notification bits,
+ *        so that one task can wait several attributes with one
+ *        xTaskNotifyWait() call.
+ */
+class FwAttrNotifyListener : public AttributeListenerInterface {
+ public:
+    FwAttrNotifyListener(TaskHandle_t task, uint32_t bits)
+        : task_(task), bits_(bits) {}
+
+    virtual void attributeChanged(FwAttribute *attr) override {
+        BaseType_t woken = pdFALSE;
+        if (IsInsideIrq()) {
+            xTaskNotifyFromISR(task_, bits_, eSetBits, &woken);
+            portYIELD_FROM_ISR(woken);
+        } else {
+            xTaskNotify(task_, bits_, eSetBits);
+        }
+    }
+
+ protected:
+    TaskHandle_t task_;
+    uint32_t bits_;
+};
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <string.h>
+#include <fwapi.h>
+#include <fwattribute.h>
+#include <uart.h>
+
+/**
+ * @brief Conversion of the attribute value into the specified C-type
+ */
+template <typename T> struct FwAttrValue;
+
+template <> struct FwAttrValue<int8_t> {
+    static int8_t get(FwAttribute *a) { return a->to_int8(); }
+};
+
+template <> struct FwAttrValue<uint8_t> {
+    static uint8_t get(FwAttribute *a) { return a->to_uint8(); }
+};
+
+template <> struct FwAttrValue<int16_t> {
+    static int16_t get(FwAttribute *a) { return a->to_int16(); }
+};
+
+template <> struct FwAttrValue<uint16_t> {
+    static uint16_t get(FwAttribute *a) { return a->to_uint16(); }
+};
+
+template <> struct FwAttrValue<int32_t> {
+    static int32_t get(FwAttribute *a) { return a->to_int32(); }
+};
+
+template <> struct FwAttrValue<uint32_t> {
+    static uint32_t get(FwAttribute *a) { return a->to_uint32(); }
+};
+
+template <> struct FwAttrValue<float> {
+    static float get(FwAttribute *a) { return a->to_float(); }
+};
+
+/**
+ * @brief Typed handle of the attribute of another FwObject. Handle should
+ *        be bound once in PostInit() stage and then it is read and written
+ *        without any string compare.
+ *
+ *   Example:
+ *        FwAttrRef<uint32_t> rtcTime_;
+ *        rtcTime_.bind("rtc", "Time");     // PostInit
+ *        uint32_t t = rtcTime_.read();     // any time later
+ */
+template <typename T> class FwAttrRef {
+ public:
+    FwAttrRef() : attr_(0), objname_(""), atrname_("") {}
+
+    /**
+     * @brief Resolve attribute pointer by object and attribute names.
+     * @param[in] objname Object name string
+     * @param[in] atrname Attribute name string
+     * @return true if the attribute was found, otherwise the handle stays
+     *         unbound and the diagnostic message is printed.
+     */
+    bool bind(const char *objname, const char *atrname) {
+        objname_ = objname;
+        atrname_ = atrname;
+        attr_ = reinterpret_cast<FwAttribute *>(
+                    fw_get_object_attribute(objname, atrname));
+        if (attr_ == 0) {
+            uart_printf("attr %s:%s unbound\r\n", objname, atrname);
+        }
+        return attr_ != 0;
+    }
+
+    bool isBound() { return attr_ != 0; }
+
+    /**
+     * @brief Read attribute value. Unbound handle returns zero.
+     */
+    T read() {
+        if (attr_ == 0) {
+            return 0;
+        }
+        return FwAttrValue<T>::get(attr_);
+    }
+
+    /**
+     * @brief Write attribute value using the same path as the external
+     *        interface so that post_write() of the target attribute is called.
+     */
+    void write(T v) {
+        char buf[sizeof(T)];
+        if (attr_ == 0) {
+            uart_printf("attr %s:%s unbound\r\n", objname_, atrname_);
+            return;
+        }
+        memcpy(buf, &v, sizeof(T));
+        attr_->write(buf, sizeof(T), false);
+    }
+
+    FwAttribute *attribute() { return attr_; }
+
+ protected:
+    FwAttribute *attr_;
+    const char *objname_;
+    const char *atrname_;
+};
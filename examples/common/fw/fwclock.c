@@ -0,0 +1,54 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "fwclock.h"
+
+volatile uint32_t fw_clock_high_ = 0;
+
+void fw_clock_init() {
+    RCC_registers_type *RCC = (RCC_registers_type *)RCC_BASE;
+    TIM_registers_type *TIM7 = (TIM_registers_type *)TIM7_BASE;
+    uint32_t t1;
+
+    t1 = read32(&RCC->APB1ENR);
+    t1 |= (1 << 5);             // APB1[5] TIM7EN
+    write32(&RCC->APB1ENR, t1);
+
+    write32(&TIM7->CR1.val, 0);         // stop counter
+    // APB1 timers clock = HCLK / 2, time scale 1 usec
+    write16(&TIM7->PSC, system_clock_hz() / 2 / 1000000 - 1);
+    write32(&TIM7->ARR, 0xFFFF);
+    write32(&TIM7->CR1.val, 1 << 2);    // [2] URS: only overflow sets UIF
+    write16(&TIM7->EGR, 1);             // [0] UG: load prescaler
+    write32(&TIM7->CNT, 0);
+    write16(&TIM7->SR, 0);
+    write16(&TIM7->DIER, 1);            // [0] UIE - update interrupt enabled
+    write32(&TIM7->CR1.val, (1 << 2) | 1);  // [0] CEN
+
+    fw_clock_high_ = 0;
+    nvic_irq_enable(FW_CLOCK_TIM_IRQ, FW_CLOCK_TIM_PRIO);
+}
+
+void fw_clock_irq_handler() {
+    TIM_registers_type *TIM7 = (TIM_registers_type *)TIM7_BASE;
+    // Flag and counter should change together for the readers preempting
+    // this handler
+    uint32_t primask = DisableIrqSave();
+    write16(&TIM7->SR, 0);
+    fw_clock_high_++;
+    RestoreIrq(primask);
+    nvic_irq_clear(FW_CLOCK_TIM_IRQ);
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+#include <mcu.h>
+
+/** TIM7 (basic 16-bit timer on APB1) counts microseconds */
+#define FW_CLOCK_TIM_IRQ 55
+
+/** Overflow extension is allowed to be delayed up to 32 ms */
+#define FW_CLOCK_TIM_PRIO 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of 65536 us periods, modified only by fw_clock_irq_handler() */
+extern volatile uint32_t fw_clock_high_;
+
+/**
+ * @brief Start the free running 1 MHz counter. Called by fw_init() before
+ *        drivers Init() so that any driver may use timestamps.
+ */
+void fw_clock_init();
+
+/**
+ * @brief Overflow handler mapped on TIM7 vector
+ */
+void fw_clock_irq_handler();
+
+/**
+ * @brief Monotonic time in microseconds since fw_clock_init().
+ *        Lock-free and safe to call from any interrupt priority and with
+ *        disabled interrupts: overflow that is pending but not yet handled
+ *        is detected by the UIF flag.
+ */
+static inline uint64_t fw_clock_get_us() {
+    TIM_registers_type *TIM7 = (TIM_registers_type *)TIM7_BASE;
+    uint32_t high;
+    uint32_t cnt;
+    uint16_t sr;
+
+    do {
+        high = fw_clock_high_;
+        cnt = read32(&TIM7->CNT) & 0xFFFF;
+        sr = read16(&TIM7->SR);
+    } while (high != fw_clock_high_);
+
+    // Counter wrapped but the overflow interrupt is still pending
+    if ((sr & 0x1) && cnt < 0x8000) {
+        high++;
+    }
+    return ((uint64_t)high << 16) | cnt;
+}
+
+/**
+ * @brief Lower 32 bits of the clock (wraps every 71 minutes) for compact
+ *        timestamps of CAN frames and samples
+ */
+static inline uint32_t fw_clock_get_us32() {
+    return (uint32_t)fw_clock_get_us();
+}
+
+#ifdef __cplusplus
+}
+#endif
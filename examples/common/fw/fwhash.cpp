@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <fwapi.h>
+#include <fwhash.h>
+#include <string.h>
+
+static int fw_hash_table_alloc(FwHashTable *t, uint32_t sz) {
+    FwHashEntry *tbl = reinterpret_cast<FwHashEntry *>(
+            fw_mem_alloc(sz * sizeof(FwHashEntry)));
+    if (tbl == 0) {
+        return 0;
+    }
+    memset(tbl, 0, sz * sizeof(FwHashEntry));
+    t->tbl = tbl;
+    t->mask = sz - 1;
+    t->cnt = 0;
+    return 1;
+}
+
+static void fw_hash_table_insert(FwHashTable *t, uint32_t hash, void *payload) {
+    uint32_t idx = hash & t->mask;
+    while (t->tbl[idx].payload) {
+        idx = (idx + 1) & t->mask;
+    }
+    t->tbl[idx].hash = hash;
+    t->tbl[idx].payload = payload;
+    t->cnt++;
+}
+
+extern "C" void fw_hash_table_init(FwHashTable *t, int entries) {
+    uint32_t sz = 4;
+    // Keep load factor lower than 3/4
+    while (4 * static_cast<uint32_t>(entries) >= 3 * sz) {
+        sz <<= 1;
+    }
+    fw_hash_table_alloc(t, sz);
+}
+
+extern "C" void fw_hash_table_add(FwHashTable *t, uint32_t hash, void *payload) {
+    if (t->tbl == 0) {
+        fw_hash_table_init(t, 1);
+        if (t->tbl == 0) {
+            return;
+        }
+    }
+    if (4 * static_cast<uint32_t>(t->cnt + 1) >= 3 * (t->mask + 1)) {
+        // Re-hash into twice larger table and release the previous one
+        FwHashEntry *old = t->tbl;
+        uint32_t oldsz = t->mask + 1;
+        if (fw_hash_table_alloc(t, 2 * oldsz)) {
+            for (uint32_t i = 0; i < oldsz; i++) {
+                if (old[i].payload) {
+                    fw_hash_table_insert(t, old[i].hash, old[i].payload);
+                }
+            }
+            fw_mem_free(old);
+        } else if (t->cnt + 1 >= oldsz) {
+            // Out of memory: keep the old table while it has a free slot
+            // left, the probe loop needs at least one empty entry
+            return;
+        }
+    }
+    fw_hash_table_insert(t, hash, payload);
+}
+
+extern "C" void *fw_hash_table_find(FwHashTable *t,
+                                    uint32_t hash,
+                                    const void *key,
+                                    fw_hash_match_type match) {
+    uint32_t idx = hash & t->mask;
+    FwHashEntry *e;
+    if (t->tbl == 0) {
+        return 0;
+    }
+    e = &t->tbl[idx];
+    while (e->payload) {
+        if (e->hash == hash && match(e->payload, key)) {
+            return e->payload;
+        }
+        idx = (idx + 1) & t->mask;
+        e = &t->tbl[idx];
+    }
+    return 0;
+}
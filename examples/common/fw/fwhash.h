@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+#define FW_HASH_OFFSET 0x811C9DC5u
+#define FW_HASH_PRIME 0x01000193u
+
+/**
+ * @brief Continue FNV-1a hash computation with the next string.
+ * @param[in] hash Previously computed hash value or FW_HASH_OFFSET
+ * @param[in] s Zero terminated string
+ * @return 32-bits hash value
+ */
+static inline uint32_t fw_hash_next(uint32_t hash, const char *s) {
+    while (*s) {
+        hash ^= (uint8_t)(*s++);
+        hash *= FW_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compute FNV-1a 32-bits hash of the object/interface/attribute name
+ *        in run-time.
+ */
+static inline uint32_t fw_hash(const char *s) {
+    return fw_hash_next(FW_HASH_OFFSET, s);
+}
+
+#ifdef __cplusplus
+/**
+ * @brief The same FNV-1a hash computed by compiler from the string literal
+ */
+constexpr uint32_t fw_hash_const(const char *s, uint32_t hash = FW_HASH_OFFSET) {
+    return *s == 0 ? hash
+        : fw_hash_const(s + 1, (hash ^ static_cast<uint8_t>(*s)) * FW_HASH_PRIME);
+}
+
+template <uint32_t H> struct FwHashValue {
+    static const uint32_t value = H;
+};
+
+/** Force compile-time hash evaluation of the string literal */
+#define FW_HASH(s) (FwHashValue<fw_hash_const(s)>::value)
+#endif
+
+/**
+ * @brief Open addressed hash table entry. Hash value is stored to avoid
+ *        strcmp() calls for the non-matching entries.
+ */
+typedef struct FwHashEntry {
+    uint32_t hash;
+    void *payload;
+} FwHashEntry;
+
+/**
+ * @brief Open addressed hash table with linear probing. Table size is always
+ *        power of 2 and load factor is kept lower than 3/4.
+ */
+typedef struct FwHashTable {
+    FwHashEntry *tbl;
+    uint32_t mask;
+    int cnt;
+} FwHashTable;
+
+/**
+ * @brief Callback to check that the payload with the equal hash value
+ *        actually matches to the requested key (hash collisions).
+ */
+typedef int (*fw_hash_match_type)(void *payload, const void *key);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocate empty hash table enough to store specified number of entries
+ * @param[in] t Pointer to the hash table
+ * @param[in] entries Expected number of entries
+ */
+void fw_hash_table_init(FwHashTable *t, int entries);
+
+/**
+ * @brief Add new entry into hash table. Table is reallocated with
+ *        fw_mem_alloc() when load factor exceeds 3/4 and the previous
+ *        table is released.
+ */
+void fw_hash_table_add(FwHashTable *t, uint32_t hash, void *payload);
+
+/**
+ * @brief Find entry with the specified hash value
+ * @param[in] t Pointer to the hash table
+ * @param[in] hash Hash value of the key
+ * @param[in] key Key passed into match callback
+ * @param[in] match Callback to resolve hash collisions
+ * @return Stored payload or zero if the entry not found
+ */
+void *fw_hash_table_find(FwHashTable *t,
+                         uint32_t hash,
+                         const void *key,
+                         fw_hash_match_type match);
+
+/**
+ * @brief Check that hash table was allocated
+ */
+static inline int fw_hash_table_is_ready(FwHashTable *t) {
+    return t->tbl != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
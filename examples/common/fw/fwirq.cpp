@@ -0,0 +1,57 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include "fwirq.h"
+
+FwIrqEntry fw_irq_table_[FW_IRQ_TOTAL] = {};
+
+void fw_irq_bind(int irqidx, IrqHandlerInterface *iface) {
+    if (irqidx < 0 || irqidx >= FW_IRQ_TOTAL) {
+        return;
+    }
+    fw_irq_table_[irqidx].iface = iface;
+}
+
+uint32_t fw_irq_get_unbound(int irqidx) {
+    if (irqidx < 0 || irqidx >= FW_IRQ_TOTAL) {
+        return 0;
+    }
+    return fw_irq_table_[irqidx].unbound;
+}
+
+uint32_t fw_irq_get_spurious(int irqidx) {
+    if (irqidx < 0 || irqidx >= FW_IRQ_TOTAL) {
+        return 0;
+    }
+    return fw_irq_table_[irqidx].spurious;
+}
+
+uint32_t fw_irq_get_unbound_total() {
+    uint32_t ret = 0;
+    for (int i = 0; i < FW_IRQ_TOTAL; i++) {
+        ret += fw_irq_table_[i].unbound;
+    }
+    return ret;
+}
+
+uint32_t fw_irq_get_spurious_total() {
+    uint32_t ret = 0;
+    for (int i = 0; i < FW_IRQ_TOTAL; i++) {
+        ret += fw_irq_table_[i].spurious;
+    }
+    return ret;
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <IrqInterface.h>
+#include <fwprof.h>
+#include <fwtrace.h>
+
+/** Number of STM32F4xx vendor specific interrupt vectors */
+#define FW_IRQ_TOTAL 82
+
+/**
+ * @brief Interrupt vector binding. Drivers bind their IrqHandlerInterface
+ *        in Init() so that the ISR does not search object by name.
+ */
+typedef struct FwIrqEntry {
+    IrqHandlerInterface *iface;
+    uint32_t unbound;       // interrupts without bound handler
+    uint32_t spurious;      // interrupts without pending hardware event
+} FwIrqEntry;
+
+extern FwIrqEntry fw_irq_table_[FW_IRQ_TOTAL];
+
+/**
+ * @brief Bind interrupt handler to the NVIC vector.
+ * @param[in] irqidx NVIC vector index 0..FW_IRQ_TOTAL-1
+ * @param[in] iface Handler interface or zero to unbind
+ */
+void fw_irq_bind(int irqidx, IrqHandlerInterface *iface);
+
+/**
+ * @brief Call bound handler of the vector and account its execution time
+ *        when profiling is enabled, record enter/exit trace events.
+ *        Safe to call from ISR only.
+ * @param[in] irqidx NVIC vector index
+ * @param[in,out] argv Handler specific argument
+ */
+static inline void fw_irq_dispatch(int irqidx, int *argv) {
+    FwIrqEntry *e = &fw_irq_table_[irqidx];
+    uint32_t t0;
+    if (e->iface) {
+        t0 = fwprof_irq_enter();
+        fw_trace_event(FWTRACE_ISR_ENTER, (uint8_t)irqidx, 0);
+        e->iface->handleInterrupt(argv);
+        fw_trace_event(FWTRACE_ISR_EXIT, (uint8_t)irqidx, 0);
+        fwprof_irq_exit(irqidx, t0);
+    } else {
+        e->unbound++;
+    }
+}
+
+/**
+ * @brief Count interrupt without pending event in the peripheral status
+ */
+static inline void fw_irq_spurious(int irqidx) {
+    fw_irq_table_[irqidx].spurious++;
+}
+
+uint32_t fw_irq_get_unbound(int irqidx);
+uint32_t fw_irq_get_spurious(int irqidx);
+
+/**
+ * @brief Sum of the counters over all vectors
+ */
+uint32_t fw_irq_get_unbound_total();
+uint32_t fw_irq_get_spurious_total();
@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+#include "fwlat.h"
+
+static FwLatStat lat_[FWLAT_SLOTS_MAX] = {
+    {-1}, {-1}, {-1}, {-1}
+};
+
+static FwLatStat *fw_lat_find(int irqidx) {
+    for (int i = 0; i < FWLAT_SLOTS_MAX; i++) {
+        if (lat_[i].irqidx == irqidx) {
+            return &lat_[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief CPU clocks per one clock of APB1 timer. Timer clock is doubled
+ *        when APB1 prescaler is not 1.
+ */
+static uint32_t apb1_timer_ratio() {
+    RCC_registers_type *RCC = (RCC_registers_type *)RCC_BASE;
+    // [12:10] PPRE1: 0xx=1; 100=2; 101=4; 110=8; 111=16
+    uint32_t ppre1 = (read32(&RCC->CFGR) >> 10) & 0x7;
+    if (ppre1 < 5) {
+        return 1;
+    }
+    return 1u << (ppre1 - 4);
+}
+
+void fw_lat_arm(int irqidx, TIM_registers_type *TIM, uint32_t ticks) {
+    FwLatStat *p;
+    if (!fwprof_enabled_) {
+        return;
+    }
+    p = fw_lat_find(irqidx);
+    if (p == 0) {
+        p = fw_lat_find(-1);
+        if (p == 0) {
+            return;
+        }
+        p->irqidx = irqidx;
+    }
+    // Down counter underflows after ticks + 1 periods
+    p->expected = (ticks + 1) * (read16(&TIM->PSC) + 1u) * apb1_timer_ratio();
+    p->t_start = fwprof_get_cycles();
+    p->armed = 1;
+}
+
+void fw_lat_isr_entry(int irqidx) {
+    uint32_t now = fwprof_get_cycles();
+    FwLatStat *p;
+    uint32_t dt;
+    int bucket = 0;
+
+    if (!fwprof_enabled_) {
+        return;
+    }
+    p = fw_lat_find(irqidx);
+    if (p == 0 || !p->armed) {
+        return;
+    }
+    p->armed = 0;
+    dt = now - p->t_start;
+    if (dt <= p->expected) {
+        dt = 0;
+    } else {
+        dt -= p->expected;
+    }
+    if (dt > p->max) {
+        p->max = dt;
+    }
+    while ((dt >> 1) && bucket < FWLAT_BUCKETS - 1) {
+        dt >>= 1;
+        bucket++;
+    }
+    p->hist[bucket]++;
+}
+
+FwLatStat *fw_lat_get_stat(int idx) {
+    if (idx < 0 || idx >= FWLAT_SLOTS_MAX) {
+        return 0;
+    }
+    return &lat_[idx];
+}
+
+void fw_lat_reset() {
+    uint32_t primask = DisableIrqSave();
+    for (int i = 0; i < FWLAT_SLOTS_MAX; i++) {
+        lat_[i].armed = 0;
+        lat_[i].max = 0;
+        memset(lat_[i].hist, 0, sizeof(lat_[i].hist));
+    }
+    RestoreIrq(primask);
+}
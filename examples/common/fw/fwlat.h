@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+#include <mcu.h>
+#include <fwprof.h>
+
+/** Number of instrumented timer interrupts */
+#define FWLAT_SLOTS_MAX 4
+
+/**
+ * @brief Number of log2 buckets: bucket k counts latencies in range
+ *        [2^k, 2^(k+1)) CPU clocks, bucket 0 includes 0 and early entries.
+ */
+#define FWLAT_BUCKETS 16
+
+/**
+ * @brief Latency statistic of one timer interrupt: delay from the expected
+ *        update event of the one-pulse timer to the ISR entry.
+ */
+typedef struct FwLatStat {
+    int irqidx;                     // NVIC index, -1 if slot is free
+    uint32_t t_start;               // CYCCNT when counter was started
+    uint32_t expected;              // CPU clocks from start to update event
+    int armed;
+    uint32_t max;                   // worst latency in CPU clocks
+    uint32_t hist[FWLAT_BUCKETS];
+} FwLatStat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Remember start time of the APB1 timer counting 'ticks' periods
+ *        of its prescaled clock. Does nothing while profiling (fwprof) is
+ *        disabled because DWT cycle counter is used as the time base.
+ * @param[in] irqidx NVIC index of the timer interrupt
+ * @param[in] TIM Timer registers with configured prescaler
+ * @param[in] ticks Value loaded into the down counter
+ */
+void fw_lat_arm(int irqidx, TIM_registers_type *TIM, uint32_t ticks);
+
+/**
+ * @brief Call first in the timer interrupt handler
+ */
+void fw_lat_isr_entry(int irqidx);
+
+/**
+ * @brief Get statistic slot by index 0..FWLAT_SLOTS_MAX-1
+ * @return Pointer to slot, irqidx < 0 if the slot is unused
+ */
+FwLatStat *fw_lat_get_stat(int idx);
+
+void fw_lat_reset();
+
+#ifdef __cplusplus
+}
+#endif
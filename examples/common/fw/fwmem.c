@@ -17,7 +17,6 @@
 #include <prjtypes.h>
 #include <string.h>
 #include <stdio.h>
-#include <uart.h>
 
 #ifdef _WIN32
 char __heap_start__[1 << 19];
@@ -30,17 +29,50 @@ extern char __stack_limit[];
 #define SP_MAGIC_VALUE 0xCCCCCCCC
 #define RAM_ENTRIES_MAX 32
 
+// All allocations are aligned to 8 bytes (double and uint64_t members)
+#define FW_MEM_ALIGN 8
+// Free space kept between arena and stack when fw_malloc() checks overflow
+#define FW_MEM_STACK_GUARD 256
+// Block sizes: 16, 32, 64, 128, 256, 512, 1024 bytes without header
+#define FW_POOL_CLASS_MIN_LOG2 4
+#define FW_POOL_CLASSES 7
+#define FW_POOL_CLASS_LARGE 0xFF
+#define FW_BLOCK_MAGIC 0xB10C
+
 typedef struct ram_data_type {
     char name[8];
     void *pattern;
 } ram_data_type;
 
+/**
+ * @brief Header of the block allocated by fw_mem_alloc(). Size is 8 bytes
+ *        to keep payload alignment.
+ */
+typedef struct fw_block_hdr_type {
+    uint16_t magic;
+    uint8_t cls;                                  // pool index or FW_POOL_CLASS_LARGE
+    uint8_t used;
+    uint32_t size;                                // payload size of the block
+} fw_block_hdr_type;
+
+typedef struct fw_free_block_type {
+    fw_block_hdr_type hdr;
+    struct fw_free_block_type *next;
+} fw_free_block_type;
+
 typedef struct memanager_type {
     char *end;                                    // pinter to heap end
     uint32_t allocated_sz;                        // heap size used
     void *magic;                                  // pointer to itself to mark initialization
     int data_cnt;                                 // Number of registered RAM modules
     ram_data_type data[RAM_ENTRIES_MAX];          // registered RAM modules
+    fw_free_block_type *pool[FW_POOL_CLASSES];    // free lists of the fixed size blocks
+    fw_free_block_type *large;                    // free list of the blocks larger than pools
+    uint32_t pool_free_sz;                        // bytes in all free lists
+    uint32_t large_free_sz;                       // bytes in the large blocks free list
+    uint32_t min_free_sz;                         // minimum ever free bytes
+    uint32_t overflow_cnt;                        // failed allocations
+    uint32_t invalid_free_cnt;                    // fw_mem_free() with a wrong pointer
 } memanager_type;
 
 static memanager_type memanager_;
@@ -49,16 +81,50 @@ static memanager_type *get_root_data() {
     return &memanager_;
 }
 
+static uint32_t arena_free_sz(memanager_type *pool) {
+    char *limit = (char *)__stack_limit - FW_MEM_STACK_GUARD;
+    if (pool->end >= limit) {
+        return 0;
+    }
+    return (uint32_t)(limit - pool->end);
+}
+
+static void update_min_free(memanager_type *pool) {
+    uint32_t t = arena_free_sz(pool) + pool->pool_free_sz + pool->large_free_sz;
+    if (t < pool->min_free_sz) {
+        pool->min_free_sz = t;
+    }
+}
+
+/**
+ * @brief Allocate aligned memory from arena. Must be called with disabled
+ *        interrupts.
+ */
+static char *arena_alloc(memanager_type *pool, int incr) {
+    char *ret = (char *)pool->end;
+    incr = (incr + (FW_MEM_ALIGN - 1)) & ~(FW_MEM_ALIGN - 1);
+    if ((uint32_t)incr > arena_free_sz(pool)) {
+        pool->overflow_cnt++;
+        return 0;
+    }
+    pool->allocated_sz += incr;
+    pool->end += incr;
+    update_min_free(pool);
+    return ret;
+}
+
 /*
  * @brief Increase program data space.
  * @details Malloc and related functions depend on this
  */
 char *_sbrk(int incr) {
     memanager_type *pool = get_root_data();
-    char *ret = (char *)pool->end;
-    incr = (incr + 3) & (~3); // align value to 4
-    pool->allocated_sz += incr;
-    pool->end += incr;
+    uint32_t primask = DisableIrqSave();
+    char *ret = arena_alloc(pool, incr);
+    RestoreIrq(primask);
+    if (ret == 0) {
+        return (char *)-1;
+    }
     return ret;
 }
 
@@ -69,11 +135,203 @@ void fw_malloc_init() {
         memset(pool, 0, sizeof(memanager_type));
         pool->end = (char *)__heap_start__;
         pool->magic = pool;
+        pool->min_free_sz = arena_free_sz(pool);
     }
 }
 
 void *fw_malloc(int size) {
-    return _sbrk(size);  
+    memanager_type *pool = get_root_data();
+    uint32_t primask = DisableIrqSave();
+    char *ret = arena_alloc(pool, size);
+    // Overflow is counted in arena_alloc(), no output from allocator
+    RestoreIrq(primask);
+    return ret;
+}
+
+/**
+ * @brief Best fit search in the large blocks free list. The tail of the
+ *        found block is split when it can serve another large request.
+ *        Must be called with disabled interrupts.
+ */
+static fw_block_hdr_type *large_alloc(memanager_type *pool, uint32_t bsz) {
+    fw_free_block_type **pprev = &pool->large;
+    fw_free_block_type **pbest = 0;
+    fw_free_block_type *blk;
+    fw_block_hdr_type *tail;
+    uint32_t rest;
+
+    for (blk = pool->large; blk; pprev = &blk->next, blk = blk->next) {
+        if (blk->hdr.size >= bsz
+            && (pbest == 0 || blk->hdr.size < (*pbest)->hdr.size)) {
+            pbest = pprev;
+        }
+    }
+    if (pbest == 0) {
+        return 0;
+    }
+    blk = *pbest;
+    *pbest = blk->next;
+    pool->large_free_sz -= blk->hdr.size + sizeof(fw_block_hdr_type);
+
+    rest = blk->hdr.size - bsz;
+    if (rest > sizeof(fw_block_hdr_type)
+                + (1u << (FW_POOL_CLASS_MIN_LOG2 + FW_POOL_CLASSES - 1))) {
+        tail = (fw_block_hdr_type *)((char *)(&blk->hdr + 1) + bsz);
+        tail->magic = FW_BLOCK_MAGIC;
+        tail->cls = FW_POOL_CLASS_LARGE;
+        tail->used = 0;
+        tail->size = rest - sizeof(fw_block_hdr_type);
+        ((fw_free_block_type *)tail)->next = pool->large;
+        pool->large = (fw_free_block_type *)tail;
+        pool->large_free_sz += rest;
+        blk->hdr.size = bsz;
+    }
+    update_min_free(pool);
+    return &blk->hdr;
+}
+
+/**
+ * @brief Return free large blocks placed on top of the arena back into
+ *        the arena. Must be called with disabled interrupts.
+ */
+static void large_trim(memanager_type *pool) {
+    fw_free_block_type **pprev = &pool->large;
+    fw_free_block_type *blk = pool->large;
+    uint32_t fullsz;
+
+    while (blk) {
+        fullsz = blk->hdr.size + sizeof(fw_block_hdr_type);
+        if ((char *)blk + fullsz != pool->end) {
+            pprev = &blk->next;
+            blk = blk->next;
+            continue;
+        }
+        *pprev = blk->next;
+        pool->large_free_sz -= fullsz;
+        pool->allocated_sz -= fullsz;
+        pool->end = (char *)blk;
+        // New top may be the other free block, restart the search
+        pprev = &pool->large;
+        blk = pool->large;
+    }
+}
+
+static int pool_class(int size) {
+    int cls = 0;
+    while (cls < FW_POOL_CLASSES
+        && size > (1 << (FW_POOL_CLASS_MIN_LOG2 + cls))) {
+        cls++;
+    }
+    return cls;
+}
+
+void *fw_mem_alloc(int size) {
+    memanager_type *pool = get_root_data();
+    fw_block_hdr_type *hdr;
+    int cls = pool_class(size);
+    uint32_t bsz = (uint32_t)size;
+    uint32_t primask;
+
+    if (cls < FW_POOL_CLASSES) {
+        bsz = 1u << (FW_POOL_CLASS_MIN_LOG2 + cls);
+    } else {
+        cls = FW_POOL_CLASS_LARGE;
+        bsz = (bsz + (FW_MEM_ALIGN - 1)) & ~(FW_MEM_ALIGN - 1);
+    }
+
+    primask = DisableIrqSave();
+    hdr = 0;
+    if (cls != FW_POOL_CLASS_LARGE && pool->pool[cls]) {
+        fw_free_block_type *blk = pool->pool[cls];
+        pool->pool[cls] = blk->next;
+        pool->pool_free_sz -= bsz + sizeof(fw_block_hdr_type);
+        hdr = &blk->hdr;
+        update_min_free(pool);
+    } else if (cls == FW_POOL_CLASS_LARGE) {
+        hdr = large_alloc(pool, bsz);
+        if (hdr) {
+            bsz = hdr->size;
+        }
+    }
+    if (hdr == 0) {
+        hdr = (fw_block_hdr_type *)arena_alloc(pool,
+                        (int)(bsz + sizeof(fw_block_hdr_type)));
+    }
+    if (hdr) {
+        hdr->magic = FW_BLOCK_MAGIC;
+        hdr->cls = (uint8_t)cls;
+        hdr->used = 1;
+        hdr->size = bsz;
+    }
+    RestoreIrq(primask);
+
+    if (hdr == 0) {
+        return 0;
+    }
+    return hdr + 1;
+}
+
+void fw_mem_free(void *ptr) {
+    memanager_type *pool = get_root_data();
+    fw_block_hdr_type *hdr;
+    uint32_t fullsz;
+    uint32_t primask;
+
+    if (ptr == 0) {
+        return;
+    }
+    hdr = (fw_block_hdr_type *)ptr - 1;
+    primask = DisableIrqSave();
+    if (hdr->magic != FW_BLOCK_MAGIC || hdr->used == 0) {
+        pool->invalid_free_cnt++;
+        RestoreIrq(primask);
+        return;
+    }
+
+    fullsz = hdr->size + sizeof(fw_block_hdr_type);
+    hdr->used = 0;
+    if ((char *)hdr + fullsz == pool->end) {
+        // The last allocated block returns into arena
+        pool->end = (char *)hdr;
+        pool->allocated_sz -= fullsz;
+        large_trim(pool);
+    } else if (hdr->cls == FW_POOL_CLASS_LARGE) {
+        fw_free_block_type *blk = (fw_free_block_type *)hdr;
+        blk->next = pool->large;
+        pool->large = blk;
+        pool->large_free_sz += fullsz;
+    } else {
+        fw_free_block_type *blk = (fw_free_block_type *)hdr;
+        blk->next = pool->pool[hdr->cls];
+        pool->pool[hdr->cls] = blk;
+        pool->pool_free_sz += fullsz;
+    }
+    RestoreIrq(primask);
+}
+
+uint32_t fw_mem_get_free_size() {
+    memanager_type *pool = get_root_data();
+    return arena_free_sz(pool) + pool->pool_free_sz + pool->large_free_sz;
+}
+
+uint32_t fw_mem_get_min_free_size() {
+    return get_root_data()->min_free_sz;
+}
+
+uint32_t fw_mem_get_allocated_size() {
+    return get_root_data()->allocated_sz;
+}
+
+uint32_t fw_mem_get_large_free_size() {
+    return get_root_data()->large_free_sz;
+}
+
+uint32_t fw_mem_get_overflow_count() {
+    return get_root_data()->overflow_cnt;
+}
+
+uint32_t fw_mem_get_invalid_free_count() {
+    return get_root_data()->invalid_free_cnt;
 }
 
 void fw_register_ram_data(const char *name, void *data) {
@@ -23,37 +23,224 @@ struct FwPortType : public FwList {
     const char *portname;
 };
 
+struct FwPortKey {
+    const char *portname;
+    const char *facename;
+};
+
+static uint32_t port_hash(const char *portname, const char *facename) {
+    return fw_hash_next(fw_hash(portname), facename);
+}
+
+static int match_attribute(void *payload, const void *key) {
+    FwAttribute *attr = reinterpret_cast<FwAttribute *>(payload);
+    return strcmp(attr->name(), reinterpret_cast<const char *>(key)) == 0;
+}
+
+static int match_interface(void *payload, const void *key) {
+    CommonInterface *iface = reinterpret_cast<CommonInterface *>(payload);
+    return strcmp(iface->GetFaceName(), reinterpret_cast<const char *>(key)) == 0;
+}
+
+static int match_port(void *payload, const void *key) {
+    FwPortType *p = reinterpret_cast<FwPortType *>(payload);
+    const FwPortKey *k = reinterpret_cast<const FwPortKey *>(key);
+    CommonInterface *iface = reinterpret_cast<CommonInterface *>(fwlist_get_payload(p));
+    return strcmp(iface->GetFaceName(), k->facename) == 0
+        && strcmp(p->portname, k->portname) == 0;
+}
+
+static int list_size(FwList *p) {
+    int ret = 0;
+    while (p) {
+        ret++;
+        p = p->next;
+    }
+    return ret;
+}
+
 FwObject::FwObject(const char *name) : CommonInterface("FwObject"),
     objname_(name),
+    objhash_(fw_hash(name)),
     attrlist_(0),
     ifacelist_(0),
-    portlist_(0)
+    portlist_(0),
+    attrtbl_(0),
+    attrcnt_(0),
+    attrmax_(0),
+    statattr_(0),
+    statattrcnt_(0)
 {
+    memset(&attrhash_, 0, sizeof(attrhash_));
+    memset(&ifacehash_, 0, sizeof(ifacehash_));
+    memset(&porthash_, 0, sizeof(porthash_));
     fw_register_object(static_cast<FwObject *>(this));
 }
 
 void FwObject::RegisterAttribute(CommonInterface *attr) {
     FwList *pnew = fw_empty_list_item();
+    if (pnew == 0) {
+        return;
+    }
     fwlist_set_payload(pnew, attr);
     fwlist_add(&attrlist_, pnew);
+    if (fw_hash_table_is_ready(&attrhash_)) {
+        fw_hash_table_add(&attrhash_,
+                          fw_hash(static_cast<FwAttribute *>(attr)->name()),
+                          attr);
+        if (attrtbl_ == 0) {
+            // Dense table wasn't allocated, lookups walk the list
+            return;
+        }
+        if (attrcnt_ == attrmax_) {
+            FwAttribute **old = attrtbl_;
+            FwAttribute **tbl = reinterpret_cast<FwAttribute **>(
+                    fw_mem_alloc((2 * attrmax_ + 1) * sizeof(FwAttribute *)));
+            if (tbl == 0) {
+                return;
+            }
+            for (int i = 0; i < attrcnt_; i++) {
+                tbl[i] = old[i];
+            }
+            attrtbl_ = tbl;
+            attrmax_ = 2 * attrmax_ + 1;
+            fw_mem_free(old);
+        }
+        attrtbl_[attrcnt_++] = static_cast<FwAttribute *>(attr);
+    }
 }
 
 void FwObject::RegisterInterface(CommonInterface *attr) {
     FwList *pnew = fw_empty_list_item();
+    if (pnew == 0) {
+        return;
+    }
     fwlist_set_payload(pnew, attr);
     fwlist_add(&ifacelist_, pnew);
+    if (fw_hash_table_is_ready(&ifacehash_)) {
+        fw_hash_table_add(&ifacehash_, fw_hash(attr->GetFaceName()), attr);
+    }
 }
 
 void FwObject::RegisterPortInterface(const char *portname, CommonInterface *attr) {
     FwPortType *pnew = reinterpret_cast<FwPortType *>(fw_malloc(sizeof(FwPortType)));
+    if (pnew == 0) {
+        return;
+    }
     pnew->portname = portname;
     fwlist_set_payload(pnew, attr);
     fwlist_add(&portlist_, pnew);
+    if (fw_hash_table_is_ready(&porthash_)) {
+        fw_hash_table_add(&porthash_,
+                          port_hash(portname, attr->GetFaceName()),
+                          pnew);
+    }
+}
+
+void FwObject::Seal() {
+    FwList *p;
+    CommonInterface *iface;
+
+    if (fw_hash_table_is_ready(&attrhash_)) {
+        return;
+    }
+
+    attrtbl_ = reinterpret_cast<FwAttribute **>(
+            fw_mem_alloc(list_size(attrlist_) * sizeof(FwAttribute *)));
+    if (attrtbl_) {
+        attrmax_ = list_size(attrlist_);
+    }
+    fw_hash_table_init(&attrhash_, statattrcnt_ + attrmax_);
+    for (int i = 0; i < statattrcnt_; i++) {
+        fw_hash_table_add(&attrhash_, statattr_[i].hash, GetAttributeByIndex(i));
+    }
+    for (p = attrlist_; p; p = p->next) {
+        FwAttribute *attr = reinterpret_cast<FwAttribute *>(fwlist_get_payload(p));
+        fw_hash_table_add(&attrhash_, fw_hash(attr->name()), attr);
+        if (attrtbl_) {
+            attrtbl_[attrcnt_++] = attr;
+        }
+    }
+
+    fw_hash_table_init(&ifacehash_, list_size(ifacelist_));
+    for (p = ifacelist_; p; p = p->next) {
+        iface = reinterpret_cast<CommonInterface *>(fwlist_get_payload(p));
+        fw_hash_table_add(&ifacehash_, fw_hash(iface->GetFaceName()), iface);
+    }
+
+    fw_hash_table_init(&porthash_, list_size(portlist_));
+    for (p = portlist_; p; p = p->next) {
+        iface = reinterpret_cast<CommonInterface *>(fwlist_get_payload(p));
+        fw_hash_table_add(&porthash_,
+                          port_hash(static_cast<FwPortType *>(p)->portname,
+                                    iface->GetFaceName()),
+                          p);
+    }
+}
+
+FwAttribute *FwObject::GetAttribute(const char *name) {
+    FwAttribute *ret = 0;
+    FwList *p = attrlist_;
+    uint32_t hash = fw_hash(name);
+    if (fw_hash_table_is_ready(&attrhash_)) {
+        return reinterpret_cast<FwAttribute *>(
+            fw_hash_table_find(&attrhash_, hash, name, match_attribute));
+    }
+    for (int i = 0; i < statattrcnt_; i++) {
+        if (statattr_[i].hash == hash) {
+            ret = GetAttributeByIndex(i);
+            if (strcmp(ret->name(), name) == 0) {
+                return ret;
+            }
+        }
+    }
+    while (p) {
+        ret = reinterpret_cast<FwAttribute *>(fwlist_get_payload(p));
+        if (strcmp(ret->name(), name) == 0) {
+            return ret;
+        }
+        p = p->next;
+    }
+    return 0;
+}
+
+FwAttribute *FwObject::GetAttributeByIndex(int idx) {
+    FwList *p = attrlist_;
+    if (idx >= 0 && idx < statattrcnt_) {
+        return reinterpret_cast<FwAttribute *>(
+            reinterpret_cast<char *>(this) + statattr_[idx].offset);
+    }
+    idx -= statattrcnt_;
+    if (attrtbl_) {
+        if (idx < 0 || idx >= attrcnt_) {
+            return 0;
+        }
+        return attrtbl_[idx];
+    }
+    while (p && idx > 0) {
+        p = p->next;
+        idx--;
+    }
+    if (idx != 0) {
+        return 0;
+    }
+    return reinterpret_cast<FwAttribute *>(fwlist_get_payload(p));
+}
+
+int FwObject::GetAttributesCount() {
+    if (attrtbl_) {
+        return statattrcnt_ + attrcnt_;
+    }
+    return statattrcnt_ + list_size(attrlist_);
 }
 
 CommonInterface *FwObject::GetInterface(const char *name) {
     CommonInterface *ret = 0;
     FwList *p = ifacelist_;
+    if (fw_hash_table_is_ready(&ifacehash_)) {
+        return reinterpret_cast<CommonInterface *>(
+            fw_hash_table_find(&ifacehash_, fw_hash(name), name, match_interface));
+    }
     while (p) {
         ret = reinterpret_cast<CommonInterface *>(fwlist_get_payload(p));
         if (strcmp(ret->GetFaceName(), name) != 0) {
@@ -69,6 +256,14 @@ CommonInterface *FwObject::GetInterface(const char *name) {
 CommonInterface *FwObject::GetPortInterface(const char *portname, const char *name) {
     CommonInterface *ret = 0;
     FwList *p = portlist_;
+    if (fw_hash_table_is_ready(&porthash_)) {
+        FwPortKey key = {portname, name};
+        p = reinterpret_cast<FwList *>(fw_hash_table_find(&porthash_,
+                                                          port_hash(portname, name),
+                                                          &key,
+                                                          match_port));
+        return reinterpret_cast<CommonInterface *>(fwlist_get_payload(p));
+    }
     while (p) {
         ret = reinterpret_cast<CommonInterface *>(fwlist_get_payload(p));
         if (strcmp(ret->GetFaceName(), name) != 0
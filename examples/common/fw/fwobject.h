@@ -18,6 +18,8 @@
 
 #include <fwattribute.h>
 #include <fwlist.h>
+#include <fwhash.h>
+#include <fwstatic.h>
 
 class FwObject : public CommonInterface {
  public:
@@ -36,12 +38,26 @@ class FwObject : public CommonInterface {
     virtual void PostInit() {}
 
     /**
-     * @brief Get list of all registered attributes of this object.
+     * @brief Get list of attributes registered in run-time. Attributes of
+     *        the static table aren't included, use GetAttributesCount() and
+     *        GetAttributeByIndex() to iterate all attributes.
      * @return Pointer to a start element of the single linked list of
      *         attributes.
      */
     FwList *GetAttributes() { return attrlist_; }
 
+    /**
+     * @brief Get attribute by its index in the list of registered attributes
+     * @param[in] idx Attribute index used as DBC multiplexor value
+     * @return Pointer to FwAttribute or zero if index is out of range
+     */
+    FwAttribute *GetAttributeByIndex(int idx);
+
+    /**
+     * @brief Get number of registered attributes
+     */
+    int GetAttributesCount();
+
     /**
      * @brief Request to modify attribute from external interface (CAN for 
      *        an example). If FwObject supports writable attributes it should
@@ -62,12 +78,32 @@ class FwObject : public CommonInterface {
 
     CommonInterface *GetPortInterface(const char *portname, const char *name);
 
+    /**
+     * @brief Get attribute pointer by its name
+     * @param[in] name Name of the requesting attribute
+     * @return Pointer to FwAttribute or zero if attribute wasn't registered
+     */
+    FwAttribute *GetAttribute(const char *name);
+
+    /**
+     * @brief Build hash tables of all registered attributes, interfaces and
+     *        ports. After this call all Get* methods do not walk the lists.
+     *        Attributes and interfaces registered later are added into
+     *        already built tables.
+     */
+    void Seal();
+
     /*
      * @brief Get object name
      * @return Pointer to an object name string
      */
     const char *ObjectName() { return objname_; }
 
+    /**
+     * @brief Get FNV-1a hash of the object name computed in constructor
+     */
+    uint32_t ObjectHash() { return objhash_; }
+
  public:
     /**
      * @brief Write attribtue into attribute list of the current object
@@ -85,12 +121,27 @@ class FwObject : public CommonInterface {
 
     void RegisterPortInterface(const char *portname, CommonInterface *iface);
 
+ protected:
+    /**
+     * @brief Use flash resident table of attributes instead of the
+     *        RegisterAttribute() calls. Static attributes get the first
+     *        indexes in the table order.
+     * @param[in] tbl Table of attributes, offsets are relative to the class
+     *                inherited from FwObject.
+     * @param[in] cnt Number of entries in the table
+     */
+    void SetStaticAttributes(const FwStaticEntry *tbl, int cnt) {
+        statattr_ = tbl;
+        statattrcnt_ = cnt;
+    }
+
  protected:
     /**
      * @brief Object name in human readable format. Any module can request
      *        pointer to FwObject using this string identificator.
      */
     const char *objname_;
+    uint32_t objhash_;
 
     /**
      * @brief Entry element pointer to a single linked list of all registered
@@ -108,4 +159,25 @@ class FwObject : public CommonInterface {
      * @brief Entry element point of registered port intefaces
      */
     FwList *portlist_;
+
+    /**
+     * @brief Hash tables built from the lists above when object is sealed
+     */
+    FwHashTable attrhash_;
+    FwHashTable ifacehash_;
+    FwHashTable porthash_;
+
+    /**
+     * @brief Dense array of attributes in the same order as attrlist_
+     *        to access attribute by DBC index without list walking
+     */
+    FwAttribute **attrtbl_;
+    int attrcnt_;
+    int attrmax_;
+
+    /**
+     * @brief Flash resident table of attributes
+     */
+    const FwStaticEntry *statattr_;
+    int statattrcnt_;
 };
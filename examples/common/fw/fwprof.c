@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+#include "fwprof.h"
+
+volatile int fwprof_enabled_ = 0;
+volatile uint32_t fwprof_irq_depth_ = 0;
+
+static FwProfStat task_stat_[FWPROF_TASKS_MAX];
+static FwProfStat irq_stat_[FWPROF_IRQ_MAX];
+static uint32_t task_t0_ = 0;
+static uint32_t task_irq_ = 0;     // interrupts time since task_t0_
+
+static void fwprof_add(FwProfStat *p, uint32_t dt) {
+    p->cycles += dt;
+    p->count++;
+    if (dt > p->max) {
+        p->max = dt;
+    }
+}
+
+void fwprof_counter_start() {
+#ifndef WIN32
+    DWT_registers_type *DWT = (DWT_registers_type *)DWT_BASE;
+    uint32_t demcr = read32((uint32_t *)SCS_DEMCR);
+    // [24] TRCENA enables DWT block, registers are not accessible without it
+    if ((demcr & (1ul << 24)) && (read32(&DWT->CTRL) & 0x1)) {
+        return;
+    }
+    write32((uint32_t *)SCS_DEMCR, demcr | (1ul << 24));
+    write32(&DWT->CYCCNT, 0);
+    write32(&DWT->CTRL, read32(&DWT->CTRL) | 0x1);
+#endif
+}
+
+void fwprof_enable(int ena) {
+    fwprof_enabled_ = 0;
+    fwprof_reset();
+    if (ena) {
+        fwprof_counter_start();
+    }
+    fwprof_irq_depth_ = 0;
+    task_irq_ = 0;
+    task_t0_ = fwprof_get_cycles();
+    fwprof_enabled_ = ena;
+}
+
+void fwprof_reset() {
+    uint32_t primask = DisableIrqSave();
+    memset(task_stat_, 0, sizeof(task_stat_));
+    memset(irq_stat_, 0, sizeof(irq_stat_));
+    RestoreIrq(primask);
+}
+
+void fwprof_task_in(void) {
+    task_irq_ = 0;
+    task_t0_ = fwprof_get_cycles();
+}
+
+void fwprof_task_out(uint32_t tasknum) {
+    uint32_t dt = fwprof_get_cycles() - task_t0_;
+    if (tasknum == 0 || tasknum > FWPROF_TASKS_MAX) {
+        return;
+    }
+    // Interrupt started before task_t0_ may be longer than the activation
+    dt = dt > task_irq_ ? dt - task_irq_ : 0;
+    fwprof_add(&task_stat_[tasknum - 1], dt);
+}
+
+void fwprof_irq_account(int irqidx, uint32_t t0) {
+    uint32_t dt = fwprof_get_cycles() - t0;
+    // Enter hook could be skipped while profiling was being enabled
+    if (fwprof_irq_depth_ > 0) {
+        fwprof_irq_depth_--;
+        if (fwprof_irq_depth_ == 0) {
+            task_irq_ += dt;
+        }
+    }
+    if (irqidx < 0 || irqidx >= FWPROF_IRQ_MAX) {
+        return;
+    }
+    fwprof_add(&irq_stat_[irqidx], dt);
+}
+
+FwProfStat *fwprof_get_task_stat(int idx) {
+    if (idx < 0 || idx >= FWPROF_TASKS_MAX) {
+        return 0;
+    }
+    return &task_stat_[idx];
+}
+
+FwProfStat *fwprof_get_irq_stat(int idx) {
+    if (idx < 0 || idx >= FWPROF_IRQ_MAX) {
+        return 0;
+    }
+    return &irq_stat_[idx];
+}
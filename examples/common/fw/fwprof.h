@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+#include <scs.h>
+#include <FreeRTOS.h>
+
+/** Number of task slots, slot is the FreeRTOS task number - 1 */
+#define FWPROF_TASKS_MAX configFW_TASKS_TOTAL
+
+/** Number of interrupt slots equal to NVIC vectors (see FW_IRQ_TOTAL) */
+#define FWPROF_IRQ_MAX 82
+
+/**
+ * @brief Execution statistic in DWT CYCCNT clocks. Counters are free
+ *        running and wrap around, consumer computes the difference.
+ */
+typedef struct FwProfStat {
+    uint32_t cycles;    // accumulated execution time
+    uint32_t count;     // number of activations
+    uint32_t max;       // longest single activation
+} FwProfStat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Hooks below do nothing but this check while profiling is disabled */
+extern volatile int fwprof_enabled_;
+/** Nesting level of the profiled interrupts */
+extern volatile uint32_t fwprof_irq_depth_;
+
+static inline uint32_t fwprof_get_cycles() {
+#ifdef WIN32
+    return 0;
+#else
+    return read32(&((DWT_registers_type *)DWT_BASE)->CYCCNT);
+#endif
+}
+
+/**
+ * @brief Enable DWT cycle counter if it is not running yet. The counter is
+ *        shared with the trace recorder (fwtrace.c) and never reset when
+ *        it is already running.
+ */
+void fwprof_counter_start();
+
+/**
+ * @brief Enable DWT cycle counter and clear all statistic
+ * @param[in] ena 1 to start profiling, 0 to stop
+ */
+void fwprof_enable(int ena);
+
+void fwprof_reset();
+
+/**
+ * @brief Called from traceTASK_SWITCHED_IN, starts the activation time
+ */
+void fwprof_task_in(void);
+
+/**
+ * @brief Called from traceTASK_SWITCHED_OUT with the TCB number. Time of
+ *        the profiled interrupts during the activation isn't accounted
+ *        to the task.
+ */
+void fwprof_task_out(uint32_t tasknum);
+
+void fwprof_irq_account(int irqidx, uint32_t t0);
+
+/**
+ * @brief Call on entry of the profiled interrupt handler
+ * @return Start time to be passed into fwprof_irq_exit()
+ */
+static inline uint32_t fwprof_irq_enter() {
+    if (!fwprof_enabled_) {
+        return 0;
+    }
+    fwprof_irq_depth_++;
+    return fwprof_get_cycles();
+}
+
+/**
+ * @brief Call on exit of the profiled interrupt handler. The time of the
+ *        nested higher priority interrupts is included. Time of the
+ *        outermost interrupt is subtracted from the interrupted task.
+ */
+static inline void fwprof_irq_exit(int irqidx, uint32_t t0) {
+    if (fwprof_enabled_) {
+        fwprof_irq_account(irqidx, t0);
+    }
+}
+
+FwProfStat *fwprof_get_task_stat(int idx);
+FwProfStat *fwprof_get_irq_stat(int idx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <string.h>
+#include "fwring.h"
+
+void fw_ring_init(FwRing *r, int itemsz, int items) {
+    uint32_t sz = 2;
+    while (sz < static_cast<uint32_t>(items)) {
+        sz <<= 1;
+    }
+    r->arr = reinterpret_cast<char *>(fw_malloc(sz * itemsz));
+    r->mask = sz - 1;
+    if (r->arr == 0) {
+        // Out of memory: zero capacity ring, always full and empty
+        r->mask = 0xFFFFFFFF;
+    }
+    r->itemsz = itemsz;
+    r->wcnt = 0;
+    r->rcnt = 0;
+}
+
+int fw_ring_write(FwRing *r, const void *buf, int cnt) {
+    const char *src = reinterpret_cast<const char *>(buf);
+    uint32_t wcnt = r->wcnt;
+    uint32_t free = r->mask + 1 - (wcnt - r->rcnt);
+    uint32_t idx = wcnt & r->mask;
+    uint32_t total = static_cast<uint32_t>(cnt);
+    uint32_t part;
+
+    if (total > free) {
+        total = free;
+    }
+    part = r->mask + 1 - idx;
+    if (part > total) {
+        part = total;
+    }
+    // The second part is non-empty only when wrapped around the array end
+    memcpy(&r->arr[idx * r->itemsz], src, part * r->itemsz);
+    memcpy(r->arr, &src[part * r->itemsz], (total - part) * r->itemsz);
+
+    // Data must be visible before the new write counter
+    data_memory_barrier();
+    r->wcnt = wcnt + total;
+    return static_cast<int>(total);
+}
+
+int fw_ring_read(FwRing *r, void *buf, int cnt) {
+    char *dst = reinterpret_cast<char *>(buf);
+    uint32_t rcnt = r->rcnt;
+    uint32_t avail = r->wcnt - rcnt;
+    uint32_t idx = rcnt & r->mask;
+    uint32_t total = static_cast<uint32_t>(cnt);
+    uint32_t part;
+
+    if (total > avail) {
+        total = avail;
+    }
+    part = r->mask + 1 - idx;
+    if (part > total) {
+        part = total;
+    }
+    data_memory_barrier();
+    memcpy(dst, &r->arr[idx * r->itemsz], part * r->itemsz);
+    memcpy(&dst[part * r->itemsz], r->arr, (total - part) * r->itemsz);
+
+    // Data must be copied before the slots are released to producer
+    data_memory_barrier();
+    r->rcnt = rcnt + total;
+    return static_cast<int>(total);
+}
+
+void *fw_ring_write_peek(FwRing *r, int *cnt) {
+    uint32_t wcnt = r->wcnt;
+    uint32_t free = r->mask + 1 - (wcnt - r->rcnt);
+    uint32_t idx = wcnt & r->mask;
+    uint32_t part = r->mask + 1 - idx;
+
+    if (part > free) {
+        part = free;
+    }
+    *cnt = static_cast<int>(part);
+    return &r->arr[idx * r->itemsz];
+}
+
+void fw_ring_write_commit(FwRing *r, int cnt) {
+    data_memory_barrier();
+    r->wcnt = r->wcnt + static_cast<uint32_t>(cnt);
+}
+
+const void *fw_ring_read_peek(FwRing *r, int *cnt) {
+    uint32_t rcnt = r->rcnt;
+    uint32_t avail = r->wcnt - rcnt;
+    uint32_t idx = rcnt & r->mask;
+    uint32_t part = r->mask + 1 - idx;
+
+    if (part > avail) {
+        part = avail;
+    }
+    data_memory_barrier();
+    *cnt = static_cast<int>(part);
+    return &r->arr[idx * r->itemsz];
+}
+
+void fw_ring_read_commit(FwRing *r, int cnt) {
+    data_memory_barrier();
+    r->rcnt = r->rcnt + static_cast<uint32_t>(cnt);
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <fwapi.h>
+
+/**
+ * @brief Single-producer/single-consumer ring buffer of fixed size items.
+ *        Producer modifies only wcnt, consumer modifies only rcnt, so that
+ *        one side can be an interrupt handler and the other one a task
+ *        without critical sections. Counters are free running and the
+ *        number of items is power of 2, so the index is (cnt & mask).
+ */
+typedef struct FwRing {
+    char *arr;
+    uint32_t mask;              // items - 1
+    uint32_t itemsz;            // item size in bytes
+    volatile uint32_t wcnt;     // total written items, producer only
+    volatile uint32_t rcnt;     // total read items, consumer only
+} FwRing;
+
+/**
+ * @brief Allocate ring buffer storage using fw_malloc()
+ * @param[in] r Pointer to the ring
+ * @param[in] itemsz Size of one item in bytes: 1 for byte stream
+ * @param[in] items Requested capacity, rounded up to power of 2.
+ *                  When fw_malloc() fails the ring gets zero capacity.
+ */
+void fw_ring_init(FwRing *r, int itemsz, int items);
+
+static inline int fw_ring_get_count(FwRing *r) {
+    return static_cast<int>(r->wcnt - r->rcnt);
+}
+
+static inline int fw_ring_get_free(FwRing *r) {
+    return static_cast<int>(r->mask + 1 - (r->wcnt - r->rcnt));
+}
+
+static inline int fw_ring_is_empty(FwRing *r) {
+    return r->wcnt == r->rcnt;
+}
+
+static inline int fw_ring_is_full(FwRing *r) {
+    return fw_ring_get_free(r) == 0;
+}
+
+/**
+ * @brief Producer side: copy items into the ring
+ * @return Number of written items, could be less than cnt if ring is full
+ */
+int fw_ring_write(FwRing *r, const void *buf, int cnt);
+
+/**
+ * @brief Consumer side: copy items from the ring
+ * @return Number of read items
+ */
+int fw_ring_read(FwRing *r, void *buf, int cnt);
+
+/**
+ * @brief Producer side: get contiguous free region to fill it in place
+ *        (DMA, frame decoders). Region is published by
+ *        fw_ring_write_commit().
+ * @param[out] cnt Number of items available in the returned region
+ * @return Pointer to the first free item
+ */
+void *fw_ring_write_peek(FwRing *r, int *cnt);
+
+void fw_ring_write_commit(FwRing *r, int cnt);
+
+/**
+ * @brief Consumer side: get contiguous region of the stored items without
+ *        copying. Items are released by fw_ring_read_commit().
+ * @param[out] cnt Number of items available in the returned region
+ * @return Pointer to the oldest item
+ */
+const void *fw_ring_read_peek(FwRing *r, int *cnt);
+
+void fw_ring_read_commit(FwRing *r, int cnt);
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <fwhash.h>
+
+/**
+ * @brief Flash resident descriptor of the FwObject or FwAttribute that is
+ *        a member of the parent class. Tables of such entries are declared
+ *        as 'static const' and do not require any RAM or run-time list
+ *        building.
+ */
+typedef struct FwStaticEntry {
+    uint32_t hash;      // FNV-1a hash of the name computed by compiler
+    uint32_t offset;    // Member offset relative to the parent class
+} FwStaticEntry;
+
+#ifdef __cplusplus
+/**
+ * @brief Declare entry of the static table. The member class should have
+ *        FwObject or FwAttribute as the first base class.
+ * @param[in] cls Parent class
+ * @param[in] member Member name of the parent class
+ * @param[in] name Name string that must be the same as used in constructor
+ *
+ * @warning offsetof() on non-standard-layout classes is conditionally
+ *          supported. GCC supports it for classes without virtual bases,
+ *          use FW_STATIC_TABLE_BEGIN/END to suppress the warning.
+ */
+#define FW_STATIC_ENTRY(cls, member, name) \
+    {FW_HASH(name), static_cast<uint32_t>(offsetof(cls, member))}
+
+#define FW_STATIC_TABLE_BEGIN \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")
+
+#define FW_STATIC_TABLE_END \
+    _Pragma("GCC diagnostic pop")
+
+#define FW_STATIC_TABLE_SIZE(tbl) \
+    static_cast<int>(sizeof(tbl) / sizeof(FwStaticEntry))
+
+/**
+ * @brief X-macro helpers. Members of the static table are listed once as
+ *        LIST(X) with items X(type, member, name, ...) where 'name' and
+ *        the optional arguments are passed into the member constructor.
+ *        The same list declares members, initializes them in the parent
+ *        constructor and generates the table, so the names and the order
+ *        cannot diverge.
+ */
+#define FW_STATIC_MEMBER(type, member, ...) type member;
+
+/** Expands into ', member(name, ...)' to continue initializer list */
+#define FW_STATIC_INIT(type, member, ...) , member(__VA_ARGS__)
+#endif
@@ -0,0 +1,282 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <string.h>
+#include <fwapi.h>
+#include "fwclock.h"
+#include "fwtimer.h"
+
+static_assert(FW_EXEC_CLASSES_TOTAL == configFW_EXEC_CLASSES,
+              "configFW_EXEC_CLASSES must match EFwExecClass");
+
+static FwTimerService services_[FW_EXEC_CLASSES_TOTAL];
+static uint32_t tick_last_ = 0;
+static uint64_t tick_high_ = 0;
+
+static void heap_swap(FwTimerService *s, int a, int b) {
+    FwTimer *t = s->heap[a];
+    s->heap[a] = s->heap[b];
+    s->heap[b] = t;
+    s->heap[a]->heapidx = a;
+    s->heap[b]->heapidx = b;
+}
+
+static void heap_up(FwTimerService *s, int idx) {
+    int parent;
+    while (idx > 0) {
+        parent = (idx - 1) >> 1;
+        if (s->heap[parent]->deadline <= s->heap[idx]->deadline) {
+            break;
+        }
+        heap_swap(s, parent, idx);
+        idx = parent;
+    }
+}
+
+static void heap_down(FwTimerService *s, int idx) {
+    int child;
+    while ((child = 2 * idx + 1) < s->heapcnt) {
+        if (child + 1 < s->heapcnt
+            && s->heap[child + 1]->deadline < s->heap[child]->deadline) {
+            child++;
+        }
+        if (s->heap[idx]->deadline <= s->heap[child]->deadline) {
+            break;
+        }
+        heap_swap(s, idx, child);
+        idx = child;
+    }
+}
+
+static void heap_insert(FwTimerService *s, FwTimer *t) {
+    t->heapidx = s->heapcnt;
+    s->heap[s->heapcnt++] = t;
+    heap_up(s, t->heapidx);
+}
+
+static void heap_remove(FwTimerService *s, FwTimer *t) {
+    int idx = t->heapidx;
+    t->heapidx = -1;
+    if (--s->heapcnt == idx) {
+        return;
+    }
+    s->heap[idx] = s->heap[s->heapcnt];
+    s->heap[idx]->heapidx = idx;
+    heap_up(s, idx);
+    heap_down(s, s->heap[idx]->heapidx);
+}
+
+static uint32_t listener_period(FwTimer *t) {
+    uint32_t period = static_cast<uint32_t>(t->listener->getTimerInterval());
+    return period ? period : 1;
+}
+
+void fw_timer_init(int cls, int maxcnt) {
+    FwTimerService *s = &services_[cls];
+    s->timers = reinterpret_cast<FwTimer *>(fw_malloc(maxcnt * sizeof(FwTimer)));
+    s->heap = reinterpret_cast<FwTimer **>(fw_malloc(maxcnt * sizeof(FwTimer *)));
+    s->task = xTaskGetCurrentTaskHandle();
+    s->maxcnt = (s->timers && s->heap) ? maxcnt : 0;
+}
+
+FwTimer *fw_timer_create(TimerListenerInterface *listener, uint32_t flags) {
+    FwTimerService *s = fw_timer_get_service(listener->getExecClass());
+    FwTimer *t;
+    if (s == 0 || s->timercnt >= s->maxcnt) {
+        return 0;
+    }
+    t = &s->timers[s->timercnt++];
+    t->listener = listener;
+    t->svc = s;
+    t->deadline = 0;
+    t->flags = flags;
+    t->active = 0;
+    t->heapidx = -1;
+    return t;
+}
+
+void fw_timer_start(FwTimer *t, uint32_t delay_ms) {
+    FwTimerService *s = t->svc;
+    uint64_t deadline = fw_timer_get_time() + delay_ms;
+    int wakeup;
+
+    taskENTER_CRITICAL();
+    if (t->heapidx >= 0) {
+        heap_remove(s, t);
+    }
+    t->deadline = deadline;
+    t->active = 1;
+    heap_insert(s, t);
+    wakeup = (s->heap[0] == t);
+    taskEXIT_CRITICAL();
+
+    if (wakeup && s->task && s->task != xTaskGetCurrentTaskHandle()) {
+        xTaskNotifyGive(s->task);
+    }
+}
+
+void fw_timer_stop(FwTimer *t) {
+    taskENTER_CRITICAL();
+    if (t->heapidx >= 0) {
+        heap_remove(t->svc, t);
+    }
+    t->active = 0;
+    taskEXIT_CRITICAL();
+}
+
+int fw_timer_call(int cls,
+                  fw_timer_call_type handler,
+                  void *ctx,
+                  const char *data,
+                  int sz) {
+    FwTimerService *s = fw_timer_get_service(cls);
+    FwTimerCall *c;
+    char tbuf[8];
+
+    if (sz > static_cast<int>(sizeof(c->data))) {
+        sz = static_cast<int>(sizeof(c->data));
+    }
+    if (s == 0 || s->task == 0 || s->task == xTaskGetCurrentTaskHandle()) {
+        memcpy(tbuf, data, sz);
+        handler(ctx, tbuf, sz);
+        return 1;
+    }
+
+    taskENTER_CRITICAL();
+    if (s->callwr - s->callrd >= FW_TIMER_CALLS_MAX) {
+        s->calldrop++;
+        taskEXIT_CRITICAL();
+        return 0;
+    }
+    c = &s->calls[s->callwr & (FW_TIMER_CALLS_MAX - 1)];
+    c->handler = handler;
+    c->ctx = ctx;
+    memcpy(c->data, data, sz);
+    c->sz = sz;
+    s->callwr++;
+    taskEXIT_CRITICAL();
+
+    xTaskNotifyGive(s->task);
+    return 1;
+}
+
+static void process_calls(FwTimerService *s) {
+    FwTimerCall c;
+    while (1) {
+        taskENTER_CRITICAL();
+        if (s->callrd == s->callwr) {
+            taskEXIT_CRITICAL();
+            break;
+        }
+        c = s->calls[s->callrd & (FW_TIMER_CALLS_MAX - 1)];
+        s->callrd++;
+        taskEXIT_CRITICAL();
+
+        c.handler(c.ctx, c.data, c.sz);
+    }
+}
+
+uint64_t fw_timer_get_time() {
+    uint64_t ret;
+    uint32_t tick;
+
+    taskENTER_CRITICAL();
+    tick = static_cast<uint32_t>(xTaskGetTickCount());
+    if (tick < tick_last_) {
+        tick_high_ += 1ull << 32;
+    }
+    tick_last_ = tick;
+    ret = (tick_high_ | tick) * portTICK_PERIOD_MS;
+    taskEXIT_CRITICAL();
+    return ret;
+}
+
+TickType_t fw_timer_process(int cls) {
+    FwTimerService *s = &services_[cls];
+    FwTimer *t;
+    uint64_t now = fw_timer_get_time();
+    uint64_t next = 0;
+    uint64_t tstart;
+    uint32_t resp;
+    int pending = 0;
+
+    process_calls(s);
+    while (1) {
+        taskENTER_CRITICAL();
+        t = s->heapcnt ? s->heap[0] : 0;
+        if (t == 0 || t->deadline > now) {
+            if (t) {
+                next = t->deadline;
+                pending = 1;
+            }
+            taskEXIT_CRITICAL();
+            break;
+        }
+        heap_remove(s, t);
+        taskEXIT_CRITICAL();
+
+        // Release delay has the tick resolution and is taken before the
+        // callback, callback duration is measured in microseconds
+        tstart = fw_clock_get_us();
+        resp = static_cast<uint32_t>(fw_timer_get_time() - t->deadline) * 1000;
+        t->listener->callbackTimer(t->deadline);
+        resp += static_cast<uint32_t>(fw_clock_get_us() - tstart);
+        if (resp > s->wcrt_us) {
+            s->wcrt_us = resp;
+        }
+        s->callbacks++;
+
+        // Callbacks take time: re-arm and the next deadlines use the
+        // current time, not the one sampled before them
+        now = fw_timer_get_time();
+        taskENTER_CRITICAL();
+        if (t->flags & FW_TIMER_ONESHOT) {
+            if (t->heapidx < 0) {
+                t->active = 0;
+            }
+        } else if (t->active && t->heapidx < 0) {
+            t->deadline += listener_period(t);
+            if (t->deadline <= now) {
+                t->deadline = now + listener_period(t);
+            }
+            heap_insert(s, t);
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    if (!pending) {
+        return portMAX_DELAY;
+    }
+    now = fw_timer_get_time();
+    if (next <= now) {
+        return 0;
+    }
+    return pdMS_TO_TICKS(static_cast<uint32_t>(next - now));
+}
+
+void fw_timer_run(int cls) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, fw_timer_process(cls));
+    }
+}
+
+FwTimerService *fw_timer_get_service(int cls) {
+    if (cls < 0 || cls >= FW_EXEC_CLASSES_TOTAL) {
+        return 0;
+    }
+    return &services_[cls];
+}
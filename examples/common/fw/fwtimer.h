@@ -0,0 +1,154 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <FreeRTOS.h>
+#include <task.h>
+#include <TimerInterface.h>
+
+/** Timer is removed from the service after the first callback */
+#define FW_TIMER_ONESHOT 0x1
+
+/**
+ * @brief Software timer of the timer service. Periodic timers re-read
+ *        getTimerInterval() of the listener on each expiration, so that
+ *        the listener may change its period in run-time.
+ */
+typedef struct FwTimer {
+    TimerListenerInterface *listener;
+    struct FwTimerService *svc;
+    uint64_t deadline;      // absolute time in ms
+    uint32_t flags;
+    int active;             // armed or callback is running
+    int heapidx;            // position in the heap, -1 if not queued
+} FwTimer;
+
+/** Deferred calls queue depth of the service, must be power of 2 */
+#define FW_TIMER_CALLS_MAX 8
+
+typedef void (*fw_timer_call_type)(void *ctx, char *data, int sz);
+
+/**
+ * @brief Call handed off into the service task by fw_timer_call()
+ */
+typedef struct FwTimerCall {
+    fw_timer_call_type handler;
+    void *ctx;
+    char data[8];
+    int sz;
+} FwTimerCall;
+
+/**
+ * @brief Timer service of one execution class (EFwExecClass) run by its
+ *        own task. Response time is measured from the deadline to the end
+ *        of the callback.
+ */
+typedef struct FwTimerService {
+    FwTimer *timers;
+    FwTimer **heap;
+    int maxcnt;
+    int timercnt;
+    int heapcnt;
+    TaskHandle_t task;
+    uint32_t wcrt_us;       // worst case response time
+    uint32_t callbacks;
+    FwTimerCall calls[FW_TIMER_CALLS_MAX];
+    uint32_t callwr;
+    uint32_t callrd;
+    uint32_t calldrop;      // fw_timer_call() on full queue
+} FwTimerService;
+
+/**
+ * @brief Allocate the min-heap of timers ordered by deadline. Should be
+ *        called once from the service task of the class before any other
+ *        fw_timer call with this class.
+ * @param[in] cls Execution class EFwExecClass
+ * @param[in] maxcnt Maximum number of timers
+ */
+void fw_timer_init(int cls, int maxcnt);
+
+/**
+ * @brief Create a stopped timer in the service of the listener's
+ *        execution class.
+ * @param[in] listener Callback interface
+ * @param[in] flags Zero for periodic timer or FW_TIMER_ONESHOT
+ * @return Pointer to timer or zero if maxcnt is reached or the service
+ *         is not initialized yet
+ */
+FwTimer *fw_timer_create(TimerListenerInterface *listener, uint32_t flags);
+
+/**
+ * @brief Arm (or re-arm) timer. Service task is woken up if the new
+ *        deadline is earlier than all others. Task context only.
+ * @param[in] t Pointer to timer
+ * @param[in] delay_ms First expiration relative to the current time
+ */
+void fw_timer_start(FwTimer *t, uint32_t delay_ms);
+
+/**
+ * @brief Disarm timer. Task context only.
+ */
+void fw_timer_stop(FwTimer *t);
+
+/**
+ * @brief Run handler in the service task of the class before its next
+ *        timer callbacks. Attributes written from other tasks (host
+ *        commands) are handed off this way, so they never race with the
+ *        listeners of the owner object. The handler is called immediately
+ *        from the service task itself or when the service is not started.
+ * @param[in] cls Execution class EFwExecClass
+ * @param[in] handler Function to call
+ * @param[in] ctx Handler context
+ * @param[in] data Data copied into the queue, up to 8 bytes
+ * @param[in] sz Data size
+ * @return 1 on success, 0 when the queue is full
+ */
+int fw_timer_call(int cls,
+                  fw_timer_call_type handler,
+                  void *ctx,
+                  const char *data,
+                  int sz);
+
+/**
+ * @brief Monotonic time in ms extended to 64 bits from the FreeRTOS tick
+ */
+uint64_t fw_timer_get_time();
+
+/**
+ * @brief Call listeners of all expired timers of the class. Periodic
+ *        deadlines are incremented by the period (absolute scheduling
+ *        without drift), missed periods are skipped instead of bursting
+ *        callbacks.
+ * @param[in] cls Execution class EFwExecClass
+ * @return Ticks until the next deadline or portMAX_DELAY
+ */
+TickType_t fw_timer_process(int cls);
+
+/**
+ * @brief Service loop of the class task: process expired timers and sleep
+ *        until the next deadline or until a timer with an earlier deadline
+ *        is started. Never returns.
+ * @param[in] cls Execution class EFwExecClass
+ */
+void fw_timer_run(int cls);
+
+/**
+ * @brief Get service of the execution class to read its statistic
+ * @return Pointer to service or zero for invalid class index
+ */
+FwTimerService *fw_timer_get_service(int cls);
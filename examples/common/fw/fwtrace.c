@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string.h>
+#include "fwtrace.h"
+
+volatile int fwtrace_enabled_ = 0;
+
+static FwTraceEvent ring_[FWTRACE_EVENTS_MAX];
+static const char *task_name_[FWTRACE_TASKS_MAX];
+static uint32_t wrcnt_ = 0;
+
+void fw_trace_enable(int ena) {
+    uint32_t primask = DisableIrqSave();
+    fwtrace_enabled_ = 0;
+    wrcnt_ = 0;
+    RestoreIrq(primask);
+    if (ena) {
+        fwprof_counter_start();
+    }
+    fwtrace_enabled_ = ena;
+}
+
+void fw_trace_put(uint8_t type, uint8_t id, uint16_t arg) {
+    FwTraceEvent *p;
+    uint32_t primask = DisableIrqSave();
+    p = &ring_[wrcnt_ & (FWTRACE_EVENTS_MAX - 1)];
+    wrcnt_++;
+    p->ts = fwprof_get_cycles();
+    p->type = type;
+    p->id = id;
+    p->arg = arg;
+    RestoreIrq(primask);
+}
+
+void fw_trace_task_create(uint32_t tasknum, const char *name) {
+    if (tasknum == 0 || tasknum > FWTRACE_TASKS_MAX) {
+        return;
+    }
+    task_name_[tasknum - 1] = name;
+}
+
+const char *fw_trace_get_task_name(int idx) {
+    if (idx < 0 || idx >= FWTRACE_TASKS_MAX || task_name_[idx] == 0) {
+        return "";
+    }
+    return task_name_[idx];
+}
+
+int fw_trace_get_count() {
+    if (wrcnt_ > FWTRACE_EVENTS_MAX) {
+        return FWTRACE_EVENTS_MAX;
+    }
+    return (int)wrcnt_;
+}
+
+uint32_t fw_trace_get_overrun() {
+    if (wrcnt_ > FWTRACE_EVENTS_MAX) {
+        return wrcnt_ - FWTRACE_EVENTS_MAX;
+    }
+    return 0;
+}
+
+FwTraceEvent *fw_trace_get_event(int idx) {
+    uint32_t start = wrcnt_ - (uint32_t)fw_trace_get_count();
+    if (idx < 0 || idx >= fw_trace_get_count()) {
+        return 0;
+    }
+    return &ring_[(start + (uint32_t)idx) & (FWTRACE_EVENTS_MAX - 1)];
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+#include <fwprof.h>
+
+/** Ring size in events, must be power of 2 (8 bytes per event) */
+#define FWTRACE_EVENTS_MAX 512
+
+/** Number of task slots to keep task names, slot is the TCB number - 1 */
+#define FWTRACE_TASKS_MAX FWPROF_TASKS_MAX
+
+/**
+ * @brief Event types. Field 'id' and 'arg' meaning:
+ *   TASK_IN:     id = TCB number
+ *   QUEUE_SEND:  id = messages waiting, arg = queue address [17:2]
+ *   QUEUE_RECV:  id = messages waiting, arg = queue address [17:2]
+ *   ISR_ENTER:   id = NVIC vector index
+ *   ISR_EXIT:    id = NVIC vector index
+ */
+enum EFwTraceEvent {
+    FWTRACE_TASK_IN = 1,
+    FWTRACE_QUEUE_SEND,
+    FWTRACE_QUEUE_RECV,
+    FWTRACE_QUEUE_SEND_ISR,
+    FWTRACE_QUEUE_RECV_ISR,
+    FWTRACE_ISR_ENTER,
+    FWTRACE_ISR_EXIT,
+};
+
+/**
+ * @brief Compact trace record. Time stamp is DWT CYCCNT that wraps around
+ *        every 2^32 clocks, host restores the full time from the sequence.
+ */
+typedef struct FwTraceEvent {
+    uint32_t ts;
+    uint8_t type;
+    uint8_t id;
+    uint16_t arg;
+} FwTraceEvent;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Hooks below do nothing but this check while tracing is disabled */
+extern volatile int fwtrace_enabled_;
+
+/**
+ * @brief Start or stop recording. Starting clears the ring buffer.
+ * @param[in] ena 1 to start recording, 0 to stop
+ */
+void fw_trace_enable(int ena);
+
+/**
+ * @brief Append event into the ring, the oldest event is overwritten when
+ *        the ring is full. Safe to call from ISR and task context.
+ */
+void fw_trace_put(uint8_t type, uint8_t id, uint16_t arg);
+
+static inline void fw_trace_event(uint8_t type, uint8_t id, uint16_t arg) {
+    if (fwtrace_enabled_) {
+        fw_trace_put(type, id, arg);
+    }
+}
+
+/**
+ * @brief Called from traceTASK_CREATE to keep task name for the host
+ * @param[in] tasknum TCB number
+ * @param[in] name Pointer on the name inside of TCB
+ */
+void fw_trace_task_create(uint32_t tasknum, const char *name);
+
+const char *fw_trace_get_task_name(int idx);
+
+/**
+ * @brief Number of events available in the ring
+ */
+int fw_trace_get_count();
+
+/**
+ * @brief Total events lost because of the ring overwrite
+ */
+uint32_t fw_trace_get_overrun();
+
+/**
+ * @brief Get recorded event starting from the oldest one
+ * @param[in] idx Event index 0..fw_trace_get_count()-1
+ */
+FwTraceEvent *fw_trace_get_event(int idx);
+
+#ifdef __cplusplus
+}
+#endif
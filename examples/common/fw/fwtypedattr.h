@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <string.h>
+#include <type_traits>
+#include <fwattribute.h>
+
+/**
+ * @brief Compile-time attribute kind of the C-type
+ */
+template <typename T> struct FwAttrKind;
+
+template <> struct FwAttrKind<int8_t> {
+    static constexpr EKindType value = Attr_Int8;
+};
+
+template <> struct FwAttrKind<uint8_t> {
+    static constexpr EKindType value = Attr_UInt8;
+};
+
+template <> struct FwAttrKind<int16_t> {
+    static constexpr EKindType value = Attr_Int16;
+};
+
+template <> struct FwAttrKind<uint16_t> {
+    static constexpr EKindType value = Attr_UInt16;
+};
+
+template <> struct FwAttrKind<int32_t> {
+    static constexpr EKindType value = Attr_Int32;
+};
+
+template <> struct FwAttrKind<uint32_t> {
+    static constexpr EKindType value = Attr_UInt32;
+};
+
+template <> struct FwAttrKind<int64_t> {
+    static constexpr EKindType value = Attr_Int64;
+};
+
+template <> struct FwAttrKind<uint64_t> {
+    static constexpr EKindType value = Attr_UInt64;
+};
+
+template <> struct FwAttrKind<float> {
+    static constexpr EKindType value = Attr_Float;
+};
+
+template <> struct FwAttrKind<double> {
+    static constexpr EKindType value = Attr_Double;
+};
+
+/**
+ * @brief Default hooks policy: nothing to do. Policy is a class with the
+ *        static pre_read()/post_write() methods, so that empty hooks are
+ *        inlined away in get()/set().
+ */
+struct FwAttrNoHooks {
+    static void pre_read(FwAttribute *attr) {}
+    static void post_write(FwAttribute *attr) {}
+};
+
+/**
+ * @brief Attribute with the fixed value type. Kind and bit size are known
+ *        at compile time and get()/set() access the storage directly
+ *        without virtual calls. It is still the regular FwAttribute and
+ *        registered by FwObject::RegisterAttribute(), so DBC and
+ *        TargetConfig use it through the common interface.
+ *
+ *   Example:
+ *        struct TaraHooks {
+ *            static void pre_read(FwAttribute *attr) {}
+ *            static void post_write(FwAttribute *attr) { ... }
+ *        };
+ *        TypedAttribute<float> alpha_;
+ *        TypedAttribute<float, TaraHooks> tara_;
+ */
+template <typename T, class Hooks = FwAttrNoHooks>
+class TypedAttribute : public FwAttribute {
+ public:
+    static constexpr EKindType KIND = FwAttrKind<T>::value;
+    static constexpr int BITS = 8 * sizeof(T);
+
+    explicit TypedAttribute(const char *name,
+                            const char *descr = "",
+                            T v = 0) : FwAttribute(name, descr) {
+        kind_ = KIND;
+        memcpy(u_.data, &v, sizeof(T));
+    }
+
+    /**
+     * @brief Read value of the attribute with the pre_read() hook
+     */
+    T get() {
+        T ret;
+        Hooks::pre_read(this);
+        memcpy(&ret, u_.data, sizeof(T));
+        return ret;
+    }
+
+    /**
+     * @brief Modify value of the attribute with the post_write() hook and
+     *        notify subscribers if any
+     */
+    void set(T v) {
+        memcpy(u_.data, &v, sizeof(T));
+        Hooks::post_write(this);
+        if (subscribers_) {
+            notify();
+        }
+    }
+
+    // FwAttribute hooks for the generic access (DBC, make_*/to_* methods)
+    virtual void pre_read() override { Hooks::pre_read(this); }
+    virtual void post_write() override { Hooks::post_write(this); }
+    virtual bool isPackable() override {
+        return std::is_same<Hooks, FwAttrNoHooks>::value;
+    }
+};
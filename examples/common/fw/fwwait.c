@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include "fwclock.h"
+#include "fwwait.h"
+
+static uint32_t busy_us_ = 0;
+static uint32_t timeouts_ = 0;
+
+void fw_wait_account(uint64_t t0) {
+    uint32_t dt = (uint32_t)(fw_clock_get_us() - t0);
+    uint32_t primask = DisableIrqSave();
+    busy_us_ += dt;
+    RestoreIrq(primask);
+}
+
+static TickType_t fw_wait_us_to_ticks(uint32_t us) {
+    uint64_t t = ((uint64_t)us * configTICK_RATE_HZ + 999999) / 1000000;
+    return t ? (TickType_t)t : 1;
+}
+
+int fw_wait_can_block() {
+    uint32_t primask = DisableIrqSave();
+    RestoreIrq(primask);
+    // taskENTER_CRITICAL() masks interrupts by BASEPRI, not PRIMASK
+    if (IsInsideIrq() || primask || GetBasePri()) {
+        return 0;
+    }
+    return xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+int fw_wait_poll(fw_wait_cond_type cond, void *arg, uint32_t timeout_us) {
+    int block = fw_wait_can_block();
+    uint64_t t0 = fw_clock_get_us();
+    int ret = 0;
+
+    while (!cond(arg)) {
+        if ((fw_clock_get_us() - t0) >= timeout_us) {
+            uint32_t primask = DisableIrqSave();
+            timeouts_++;
+            RestoreIrq(primask);
+            ret = -1;
+            break;
+        }
+        if (block) {
+            vTaskDelay(1);
+        }
+    }
+    if (!block) {
+        fw_wait_account(t0);
+    }
+    return ret;
+}
+
+void fw_wait_delay_us(uint32_t us) {
+    uint64_t t0;
+
+    if (fw_wait_can_block()) {
+        // The first tick may come right after the call: one more tick
+        // guarantees at least the requested delay
+        vTaskDelay(fw_wait_us_to_ticks(us) + 1);
+        return;
+    }
+    t0 = fw_clock_get_us();
+    while ((fw_clock_get_us() - t0) < us) {}
+    fw_wait_account(t0);
+}
+
+uint32_t fw_wait_get_busy_us() {
+    return busy_us_;
+}
+
+uint32_t fw_wait_get_timeouts() {
+    return timeouts_;
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <prjtypes.h>
+
+/**
+ * @brief Condition callback of the poll-with-yield wait
+ * @return Non-zero when the awaited hardware state is reached
+ */
+typedef int (*fw_wait_cond_type)(void *arg);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check that the caller may block: it is a task and the scheduler
+ *        is running with enabled interrupts (neither PRIMASK nor BASEPRI
+ *        critical section). Otherwise waits fall back to spinning.
+ */
+int fw_wait_can_block();
+
+/**
+ * @brief Wait until the condition becomes true. Task context yields the CPU
+ *        for one tick between checks, interrupt and pre-scheduler contexts
+ *        spin and this time is accounted by fw_wait_get_busy_us().
+ * @param[in] cond Condition callback
+ * @param[in] arg Argument passed into callback
+ * @param[in] timeout_us Maximum wait time in microseconds
+ * @return 0 on success, -1 on timeout
+ */
+int fw_wait_poll(fw_wait_cond_type cond, void *arg, uint32_t timeout_us);
+
+/**
+ * @brief Delay not shorter than the specified time. Task context sleeps
+ *        (the delay is rounded up to the tick), otherwise it spins.
+ * @param[in] us Delay in microseconds
+ */
+void fw_wait_delay_us(uint32_t us);
+
+/**
+ * @brief Add the time of the caller's own spin loop into the busy time,
+ *        for waits too short to yield the CPU (one SPI byte and alike)
+ * @param[in] t0 Start of the spin loop by fw_clock_get_us()
+ */
+void fw_wait_account(uint64_t t0);
+
+/**
+ * @brief Total time in microseconds spent in spinning waits
+ */
+uint32_t fw_wait_get_busy_us();
+
+/**
+ * @brief Number of fw_wait_poll() calls ended by timeout
+ */
+uint32_t fw_wait_get_timeouts();
+
+#ifdef __cplusplus
+}
+#endif
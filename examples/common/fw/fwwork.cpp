@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <prjtypes.h>
+#include <mcu.h>
+#include "fwwork.h"
+
+static FwWorkQueue queues_[FW_WORK_QUEUES_TOTAL];
+
+int fw_work_post(int qidx, fw_work_handler_type handler, void *ctx, uint32_t arg) {
+    FwWorkQueue *q = &queues_[qidx];
+    FwWorkItem *p;
+    uint32_t depth;
+    uint32_t primask = DisableIrqSave();
+
+    depth = q->wcnt - q->rcnt;
+    if (depth >= FW_WORK_ITEMS_MAX) {
+        q->overrun++;
+        RestoreIrq(primask);
+        return 0;
+    }
+    p = &q->items[q->wcnt & (FW_WORK_ITEMS_MAX - 1)];
+    p->handler = handler;
+    p->ctx = ctx;
+    p->arg = arg;
+    q->wcnt++;
+    if (depth + 1 > q->maxdepth) {
+        q->maxdepth = depth + 1;
+    }
+    RestoreIrq(primask);
+
+    nvic_irq_set_pending(FW_WORK_SWI_IRQ);
+    return 1;
+}
+
+extern "C" void fw_work_irq_handler() {
+    BaseType_t woken = pdFALSE;
+    FwWorkQueue *q;
+
+    nvic_irq_clear(FW_WORK_SWI_IRQ);
+    for (int i = 0; i < FW_WORK_QUEUES_TOTAL; i++) {
+        q = &queues_[i];
+        if (q->task && q->wcnt != q->rcnt) {
+            vTaskNotifyGiveFromISR(q->task, &woken);
+        }
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+void fw_work_run(int qidx) {
+    FwWorkQueue *q = &queues_[qidx];
+    FwWorkItem item;
+
+    q->task = xTaskGetCurrentTaskHandle();
+    nvic_irq_enable(FW_WORK_SWI_IRQ, FW_WORK_SWI_PRIO);
+
+    while (1) {
+        // Items posted before the task started are executed without waiting
+        while (q->rcnt != q->wcnt) {
+            data_memory_barrier();
+            item = q->items[q->rcnt & (FW_WORK_ITEMS_MAX - 1)];
+            // Slot must be copied before it is released to the producer
+            data_memory_barrier();
+            q->rcnt++;
+            item.handler(item.ctx, item.arg);
+            q->executed++;
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+FwWorkQueue *fw_work_get_queue(int qidx) {
+    if (qidx < 0 || qidx >= FW_WORK_QUEUES_TOTAL) {
+        return 0;
+    }
+    return &queues_[qidx];
+}
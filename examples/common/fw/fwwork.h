@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+#include <FreeRTOS.h>
+#include <task.h>
+
+/**
+ * Unused NVIC vector (HASH_RNG) triggered by software to wake up workers.
+ * Interrupts with priority above configMAX_SYSCALL_INTERRUPT_PRIORITY (CAN,
+ * UART) must not call FreeRTOS API, so they only set this vector pending
+ * and the notification is sent from its handler.
+ */
+#define FW_WORK_SWI_IRQ 80
+#define FW_WORK_SWI_PRIO 6
+
+/** Queue capacity in items, must be power of 2 */
+#define FW_WORK_ITEMS_MAX 32
+
+/** Deferred work queues, each is served by its own task */
+enum EFwWorkQueue {
+    FW_WORK_HIGH,       // served by the highest priority task
+    FW_WORK_QUEUES_TOTAL
+};
+
+/**
+ * @brief Deferred handler called from the worker task
+ * @param[in] ctx Context pointer, usually driver instance
+ * @param[in] arg Argument captured by the interrupt handler
+ */
+typedef void (*fw_work_handler_type)(void *ctx, uint32_t arg);
+
+typedef struct FwWorkItem {
+    fw_work_handler_type handler;
+    void *ctx;
+    uint32_t arg;
+} FwWorkItem;
+
+/**
+ * @brief Multi-producer (any interrupt level) single consumer queue.
+ *        Items are stored statically so that interrupts may post work
+ *        before the scheduler is started.
+ */
+typedef struct FwWorkQueue {
+    FwWorkItem items[FW_WORK_ITEMS_MAX];
+    volatile uint32_t wcnt;     // producers, under disabled interrupts
+    volatile uint32_t rcnt;     // worker task only
+    uint32_t maxdepth;          // high water mark
+    uint32_t overrun;           // rejected items because queue was full
+    uint32_t executed;
+    TaskHandle_t task;
+} FwWorkQueue;
+
+/**
+ * @brief Post work item from interrupt handler of any priority in O(1)
+ * @param[in] qidx Queue index EFwWorkQueue
+ * @param[in] handler Function executed in the worker task context
+ * @param[in] ctx Handler context
+ * @param[in] arg Handler argument
+ * @return 1 if queued, 0 if the queue is full (overrun is counted)
+ */
+int fw_work_post(int qidx, fw_work_handler_type handler, void *ctx, uint32_t arg);
+
+/**
+ * @brief Worker loop: execute queued items in FIFO order and sleep while
+ *        the queue is empty. Never returns.
+ * @param[in] qidx Queue index EFwWorkQueue
+ */
+void fw_work_run(int qidx);
+
+/**
+ * @brief Software interrupt handler that notifies workers with non-empty
+ *        queues. Should be mapped on FW_WORK_SWI_IRQ vector.
+ */
+extern "C" void fw_work_irq_handler();
+
+/**
+ * @brief Queue statistic or zero if index is out of range
+ */
+FwWorkQueue *fw_work_get_queue(int qidx);
+
+static inline uint32_t fw_work_get_depth(FwWorkQueue *q) {
+    return q->wcnt - q->rcnt;
+}
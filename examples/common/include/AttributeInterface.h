@@ -0,0 +1,33 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+
+#include "CommonInterface.h"
+
+class FwAttribute;
+
+class AttributeListenerInterface : public CommonInterface {
+ public:
+    AttributeListenerInterface()
+        : CommonInterface("AttributeListenerInterface") {}
+
+    /**
+     * @brief Attribute value was modified. Called from the context that
+     *        writes the attribute: task or interrupt handler.
+     * @param[in] attr Pointer to the modified attribute
+     */
+    virtual void attributeChanged(FwAttribute *attr) = 0;
+};
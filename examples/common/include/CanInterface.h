@@ -33,6 +33,54 @@ class CanInterface : public CommonInterface {
 
     virtual void SetBaudrated(uint32_t baud) = 0;
     virtual void StartListenerMode() = 0;
+    /**
+     * @brief Subscribe on all received frames
+     */
     virtual void RegisterCanListener(CanListenerInterface *iface) = 0;
+    /**
+     * @brief Subscribe on frames with (frame.id & mask) == (id & mask).
+     *        Mask with all bits set is an exact ID subscription. Listeners
+     *        are called from task context and should be registered in
+     *        Init()/PostInit(). When at least one listener is registered
+     *        the driver itself drains the receive ring.
+     * @param[in] id Identifier in the can_frame_type::id format
+     * @param[in] mask Significant bits of the identifier
+     */
+    virtual void RegisterCanListener(CanListenerInterface *iface,
+                                     uint32_t id,
+                                     uint32_t mask) = 0;
+    /**
+     * @brief Add identifiers to the hardware acceptance filter. Filters
+     *        of the registered listeners are added automatically. Without
+     *        any filter the bus is monitored completely.
+     * @param[in] id Identifier in the can_frame_type::id format, the
+     *               CAN_ID_EXT flag selects the extended identifier
+     * @param[in] mask Significant bits, all bits set for the exact ID.
+     *                 IDE is compared only if CAN_ID_EXT is in the mask.
+     */
+    virtual void AddAcceptanceFilter(uint32_t id, uint32_t mask) = 0;
+    /**
+     * @brief Compile the accepted identifiers into the filter banks
+     */
+    virtual void ApplyAcceptanceFilters() = 0;
+    /**
+     * @brief Polling read of the received frame. When listeners exist the
+     *        frames passed the acceptance filters are copied for the poller
+     *        starting from the first call.
+     * @return 1 if frame is copied, 0 otherwise
+     */
     virtual int ReadCanFrame(can_frame_type *frame) = 0;
+    /**
+     * @brief Queue frame for transmission without blocking. Frames are
+     *        sent in the CAN ID priority order.
+     * @return 1 if queued, 0 if the transmit queue is full or the bus is
+     *         in the silent (listen only) mode
+     */
+    virtual int WriteCanFrame(can_frame_type *frame) = 0;
+    /**
+     * @brief Drain up to max received frames in one call. The same
+     *        restriction as for ReadCanFrame() is applied.
+     * @return Number of frames copied into the array
+     */
+    virtual int ReadCanFrames(can_frame_type *frames, int max) = 0;
 };
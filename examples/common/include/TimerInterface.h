@@ -17,12 +17,26 @@
 
 #include "CommonInterface.h"
 
+/**
+ * @brief Execution class of the timer callbacks. Each class is served by
+ *        its own task, so that a slow callback delays only listeners of
+ *        the same class. Lower value is the higher task priority.
+ */
+enum EFwExecClass {
+    FW_EXEC_REALTIME,       // hardware timing: conversions, motor control
+    FW_EXEC_SENSOR,         // sensors processing
+    FW_EXEC_COMMS,          // host and bus commands parsing
+    FW_EXEC_BACKGROUND,     // statistic, indication
+    FW_EXEC_CLASSES_TOTAL
+};
+
 class TimerListenerInterface : public CommonInterface {
  public:
     TimerListenerInterface() : CommonInterface("TimerListenerInterface") {}
 
     virtual uint64_t getTimerInterval() = 0;
     virtual void callbackTimer(uint64_t tickcnt) = 0;
+    virtual int getExecClass() { return FW_EXEC_SENSOR; }
 };
 
 
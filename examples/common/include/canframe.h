@@ -17,8 +17,6 @@
 
 #include <inttypes.h>
 
-#define OBJ_MSG_ID(objidx) (0x100 | (objidx << 8))
-
 /*
  * @brief CAN ID used in FW to form DBC output and CAN filters
  * @{
@@ -35,6 +33,20 @@ static const uint32_t CAN_MSG_ID_READ_DATA = 0x777;
  *        Rx CAN filter and properly handle Read/Write request
  */
 static const uint32_t CAN_MSG_ID_WRITE_DATA = 0x778;
+/**
+ * @brief IDE flag of can_frame_type::id: extended 29-bit identifier in
+ *        bits [28:0]. Without the flag bits [10:0] are standard identifier.
+ */
+static const uint32_t CAN_ID_EXT = 0x80000000;
+/**
+ * @brief Base of the DBC messages of the kernel objects. Requests,
+ *        responses and telemetry of the object use the same extended ID
+ *        OBJ_MSG_ID(objidx), that is also printed in the BO_ lines. One
+ *        mask acceptance filter passes the whole range of 256 objects.
+ */
+static const uint32_t CAN_DBC_REQUEST_ID = 0x100;
+
+#define OBJ_MSG_ID(objidx) (CAN_DBC_REQUEST_ID | (uint32_t)(objidx))
 /**
  * @}
  */
@@ -47,7 +59,7 @@ typedef union can_payload_type {
 } can_payload_type;
 
 typedef struct can_frame_type {
-    uint32_t timestamp;
+    uint32_t timestamp;     // [us] lower 32 bits of fw_clock_get_us()
     uint32_t id;
     uint8_t dlc;
     uint8_t busid;
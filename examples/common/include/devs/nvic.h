@@ -76,3 +76,9 @@ static inline void nvic_irq_clear(int idx) {
         write32(&NVIC->ICPR[idx >> 5], (1ul << (idx & 0x1F)));
     }
 }
+
+// Software trigger of the interrupt vector
+static inline void nvic_irq_set_pending(int idx) {
+    NVIC_registers_type *NVIC = (NVIC_registers_type *)NVIC_BASE;
+    write32(&NVIC->ISPR[idx >> 5], (1ul << (idx & 0x1F)));
+}
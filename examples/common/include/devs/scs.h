@@ -58,6 +58,14 @@ typedef struct SCB_registers_type
 } SCB_registers_type;
 
 
+/** Data Watchpoint and Trace unit, cycle counter part only */
+typedef struct DWT_registers_type
+{
+    volatile uint32_t CTRL;      // [RW] [0] CYCCNTENA enable cycle counter
+    volatile uint32_t CYCCNT;    // [RW] Cycle Count Register
+} DWT_registers_type;
+
+
 /* System Control Space memory map */
 #define SCS_BASE              ((addr_t)0xE000E000)
 
@@ -66,4 +74,6 @@ typedef struct SCB_registers_type
 #define NVIC_BASE             (SCS_BASE + 0x0100)
 #define SCB_BASE              (SCS_BASE + 0x0D00)
 #define SCS_STIR              (SCS_BASE + 0x0F00)   // [WO] Software Trigger Interrupt Register
+#define SCS_DEMCR             (SCS_BASE + 0x0DFC)   // [RW] Debug Exception and Monitor Control Register, [24] TRCENA
+#define DWT_BASE              ((addr_t)0xE0001000)
 
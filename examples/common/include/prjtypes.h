@@ -44,7 +44,12 @@ uint64_t read64(const volatile uint64_t *adr);
 
 static void EnableIrqGlobal() {}
 static void DisableIrqGlobal() {}
+static uint32_t DisableIrqSave() { return 0; }
+static void RestoreIrq(uint32_t primask) {}
+static int IsInsideIrq() { return 0; }
+static uint32_t GetBasePri() { return 0; }
 static inline void memory_barrier() {}
+static inline void data_memory_barrier() {}
 
 #else
 
@@ -103,10 +108,60 @@ static inline void DisableIrqGlobal(void)
 }
 
 
+/**
+ * @brief Disable interrupts and return previous PRIMASK value. Can be
+ *        used in nested critical sections and from ISR.
+ */
+static inline uint32_t DisableIrqSave(void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+/**
+ * @brief Restore PRIMASK value saved by DisableIrqSave()
+ */
+static inline void RestoreIrq(uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/**
+ * @brief Check that the code is executed in the exception handler
+ * @return Non-zero IPSR value (active exception number) in ISR
+ */
+static inline int IsInsideIrq(void)
+{
+    uint32_t ipsr;
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr != 0;
+}
+
+/**
+ * @brief Read BASEPRI raised by the RTOS critical section
+ * @return Non-zero value when interrupts up to this priority are masked
+ */
+static inline uint32_t GetBasePri(void)
+{
+    uint32_t basepri;
+    __asm volatile ("mrs %0, basepri" : "=r" (basepri));
+    return basepri;
+}
+
+
 static inline void memory_barrier() {
    __asm("DSB");
 }
 
+/**
+ * @brief Complete all explicit memory accesses before the following ones.
+ *        Also works as compiler barrier.
+ */
+static inline void data_memory_barrier() {
+    __asm volatile ("dmb" : : : "memory");
+}
+
 #endif              
 
 #ifdef __cplusplus
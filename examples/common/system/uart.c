@@ -25,6 +25,14 @@ static void uart_putc(USART_registers_type *dev, char s, char ctx) {
     write16(&dev->DR, (uint8_t)s);
 }
 
+static f_putch uart_writer_ = 0;
+static void *uart_writer_ctx_ = 0;
+
+void uart_set_printk_writer(void (*writer)(int ch, void *ctx), void *ctx) {
+    uart_writer_ctx_ = ctx;
+    uart_writer_ = writer;
+}
+
 int uart_putchar(int ch, void *putdat) {
     USART_registers_type *dev = (USART_registers_type *)putdat;
     uart_putc(dev, (char)ch, 0);
@@ -34,6 +42,11 @@ int uart_putchar(int ch, void *putdat) {
 void uart_printk(const char *fmt, ...) {
     va_list ap;
     va_start(ap, fmt);
-    vprintfmt_lib((f_putch)uart_putchar, (void *)USART1_BASE, fmt, ap);
+    if (uart_writer_ && !IsInsideIrq()) {
+        // Do not spin on TXE for every character, use the driver's ring
+        vprintfmt_lib(uart_writer_, uart_writer_ctx_, fmt, ap);
+    } else {
+        vprintfmt_lib((f_putch)uart_putchar, (void *)USART1_BASE, fmt, ap);
+    }
     va_end(ap);
 }
@@ -25,9 +25,13 @@ extern "C"
 {
 #endif
 
-// unbuffered output
+// unbuffered output until the buffered writer is registered and
+// always from interrupts
 void uart_printk(const char *fmt, ...);
 
+// redirect uart_printk() from the thread mode into the driver's Tx ring
+void uart_set_printk_writer(void (*writer)(int ch, void *ctx), void *ctx);
+
 // buffered output. Do not use it from interrupts.
 void uart_printf(const char *fmt, ...);
 
@@ -49,9 +49,8 @@ extern uint32_t SystemCoreClock;
 #define configUSE_TICK_HOOK				1
 #define configCPU_CLOCK_HZ				( SystemCoreClock )
 #define configTICK_RATE_HZ				( ( TickType_t ) 1000 )
-#define configMAX_PRIORITIES			( 5 )
+#define configMAX_PRIORITIES			( 7 )  // idle, epoch, 4 timer classes, work queue
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 130 )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 75 * 1024 ) )
 #define configMAX_TASK_NAME_LEN			( 10 )
 #define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			0
@@ -65,6 +64,56 @@ extern uint32_t SystemCoreClock;
 #define configUSE_COUNTING_SEMAPHORES	1
 #define configGENERATE_RUN_TIME_STATS	0
 
+/* Tickless idle. SysTick stays the time base and is reloaded to the nearest
+task deadline (up to 0xFFFFFF core clocks), so xTaskGetTickCount() stays
+accurate. Sleep residency is accumulated by pwrstat.cpp. The simulator port
+does not support tick suppression. */
+#ifndef WIN32
+#define configUSE_TICKLESS_IDLE					1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP	2
+extern void pwrstat_sleep_begin(void);
+extern void pwrstat_sleep_end(void);
+#define traceLOW_POWER_IDLE_BEGIN()				pwrstat_sleep_begin()
+#define traceLOW_POWER_IDLE_END()				pwrstat_sleep_end()
+#else
+#define configUSE_TICKLESS_IDLE					0
+#endif
+
+/* Tasks created by the firmware: work queue, one timer service task per
+EFwExecClass, epoch, telemetry, IDLE and timer service. Per-task tables of
+fwprof.c, fwtrace.c and memstat.cpp are sized by this value and task creation
+asserts it. */
+#define configFW_EXEC_CLASSES			4
+#define configFW_TASKS_TOTAL			( configFW_EXEC_CLASSES + 5 )
+
+/* Per-task CPU load in DWT cycles (fwprof.c). While profiling is disabled
+the context switch costs one flag check. */
+extern volatile int fwprof_enabled_;
+extern void fwprof_task_in(void);
+extern void fwprof_task_out(uint32_t tasknum);
+#define traceTASK_SWITCHED_IN() \
+	do { if (fwprof_enabled_) { fwprof_task_in(); } \
+	     if (fwtrace_enabled_) { fw_trace_put(1, (uint8_t)pxCurrentTCB->uxTCBNumber, 0); } } while (0)
+#define traceTASK_SWITCHED_OUT() \
+	do { if (fwprof_enabled_) { fwprof_task_out(pxCurrentTCB->uxTCBNumber); } } while (0)
+
+/* Event recorder into RAM ring (fwtrace.c), event codes are EFwTraceEvent.
+Queue is identified by its address bits [17:2], ISR enter/exit events are
+recorded by fw_irq_dispatch(). */
+extern volatile int fwtrace_enabled_;
+extern void fw_trace_put(uint8_t type, uint8_t id, uint16_t arg);
+extern void fw_trace_task_create(uint32_t tasknum, const char *name);
+#define FWTRACE_QUEUE(type, q) \
+	do { if (fwtrace_enabled_) { fw_trace_put(type, (uint8_t)(q)->uxMessagesWaiting, \
+	     (uint16_t)((uintptr_t)(q) >> 2)); } } while (0)
+#define traceTASK_CREATE(pxNewTCB) \
+	do { configASSERT((pxNewTCB)->uxTCBNumber <= configFW_TASKS_TOTAL); \
+	     fw_trace_task_create((pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName); } while (0)
+#define traceQUEUE_SEND(pxQueue)				FWTRACE_QUEUE(2, pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue)				FWTRACE_QUEUE(3, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)		FWTRACE_QUEUE(4, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)	FWTRACE_QUEUE(5, pxQueue)
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
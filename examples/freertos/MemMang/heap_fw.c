@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * FreeRTOS memory manager on top of the firmware allocator (fwmem.c).
+ * Kernel objects (TCB, queues, timers) are taken from the fixed size pools,
+ * task stacks from the common arena, so that firmware and FreeRTOS share
+ * the same RAM region instead of the static ucHeap of heap_4.c.
+ */
+#include <string.h>
+
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+// Defined in fwmem.c
+void *fw_mem_alloc(int size);
+void fw_mem_free(void *ptr);
+uint32_t fw_mem_get_free_size();
+uint32_t fw_mem_get_min_free_size();
+
+static size_t xAllocations = 0;
+static size_t xFrees = 0;
+
+void *pvPortMalloc(size_t xWantedSize) {
+    void *pvReturn = 0;
+
+    if (xWantedSize != 0 && xWantedSize < 0x7FFFFFFF) {
+        pvReturn = fw_mem_alloc((int)xWantedSize);
+    }
+    traceMALLOC(pvReturn, xWantedSize);
+
+    if (pvReturn == 0) {
+#if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+#endif
+    } else {
+        xAllocations++;
+    }
+    return pvReturn;
+}
+
+void vPortFree(void *pv) {
+    if (pv == 0) {
+        return;
+    }
+    traceFREE(pv, 0);
+    fw_mem_free(pv);
+    xFrees++;
+}
+
+size_t xPortGetFreeHeapSize(void) {
+    return fw_mem_get_free_size();
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void) {
+    return fw_mem_get_min_free_size();
+}
+
+void vPortInitialiseBlocks(void) {
+    // fw_malloc_init() is called by fw_init()
+}
+
+void *pvPortCalloc(size_t xNum, size_t xSize) {
+    void *pv = 0;
+    if (xSize != 0 && xNum <= (0x7FFFFFFF / xSize)) {
+        pv = pvPortMalloc(xNum * xSize);
+        if (pv != 0) {
+            memset(pv, 0, xNum * xSize);
+        }
+    }
+    return pv;
+}
+
+void vPortGetHeapStats(HeapStats_t *pxHeapStats) {
+    taskENTER_CRITICAL();
+    pxHeapStats->xAvailableHeapSpaceInBytes = fw_mem_get_free_size();
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = 0;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = 0;
+    pxHeapStats->xNumberOfFreeBlocks = 0;
+    pxHeapStats->xMinimumEverFreeBytesRemaining = fw_mem_get_min_free_size();
+    pxHeapStats->xNumberOfSuccessfulAllocations = xAllocations;
+    pxHeapStats->xNumberOfSuccessfulFrees = xFrees;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "clocksync.h"
+#include <QDateTime>
+#include <chrono>
+
+static qint64 host_time_us() {
+    return QDateTime::currentMSecsSinceEpoch() * 1000;
+}
+
+ClockSync::ClockSync(QObject *parent) :
+    QObject(parent),
+    valid_(false),
+    offset_(0),
+    bestRtt_(0),
+    t0_(0),
+    t1_(0),
+    low_(0) {
+    connect(&timer_, &QTimer::timeout, this, &ClockSync::slotSync);
+}
+
+void ClockSync::slotSerialPortOpened() {
+    // Target could be reset, previous estimation is invalid
+    valid_ = false;
+    slotSync();
+    timer_.start(std::chrono::seconds{SYNC_PERIOD_SEC});
+}
+
+void ClockSync::slotSerialPortClosed() {
+    timer_.stop();
+}
+
+void ClockSync::slotSync() {
+    t0_ = host_time_us();
+    t1_ = 0;
+    emit signalRequestReadAttribute("kernel", "ClockUs");
+}
+
+void ClockSync::slotResponseAttribute(const QString &objname,
+                                      const QString &atrname,
+                                      quint32 val) {
+    if (objname != "kernel") {
+        return;
+    }
+    if (atrname == "ClockUs") {
+        t1_ = host_time_us();
+        low_ = val;
+        emit signalRequestReadAttribute("kernel", "ClockHi");
+    } else if (atrname == "ClockHi" && t1_ != 0) {
+        quint64 target = (static_cast<quint64>(val) << 32) | low_;
+        qint64 rtt = t1_ - t0_;
+        qint64 offset = t0_ + rtt / 2 - static_cast<qint64>(target);
+
+        // Keep the estimation with the shortest round trip but follow the
+        // crystals drift using exchanges with comparable round trips
+        if (!valid_ || rtt < bestRtt_) {
+            bestRtt_ = rtt;
+        }
+        if (!valid_ || rtt <= 2 * bestRtt_) {
+            offset_ = offset;
+            valid_ = true;
+        }
+        t1_ = 0;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief Map the target monotonic clock (kernel:ClockUs/ClockHi, in us
+ *        since reset) onto the host wall-clock. Host time is taken before
+ *        the request and after the response, the target time is assumed to
+ *        be in the middle of this round trip. The exchange with the shortest
+ *        round trip is kept as the most accurate one.
+ */
+class ClockSync : public QObject {
+    Q_OBJECT
+
+ public:
+    explicit ClockSync(QObject *parent = nullptr);
+
+    bool isValid() { return valid_; }
+
+    /**
+     * @brief Convert target time into host time
+     * @param[in] target_us Target time in us since reset
+     * @return Microseconds since Unix epoch
+     */
+    qint64 toWallClockUs(quint64 target_us) {
+        return static_cast<qint64>(target_us) + offset_;
+    }
+
+ signals:
+    void signalRequestReadAttribute(const QString &objname, const QString &atrname);
+
+ public slots:
+    void slotSerialPortOpened();
+    void slotSerialPortClosed();
+    void slotResponseAttribute(const QString &objname, const QString &atrname, quint32 val);
+
+ private slots:
+    void slotSync();
+
+ private:
+    static const int SYNC_PERIOD_SEC = 60;
+
+    QTimer timer_;
+    bool valid_;
+    qint64 offset_;         // host us minus target us
+    qint64 bestRtt_;        // us
+    qint64 t0_;             // host time of the ClockUs request
+    qint64 t1_;             // host time of the ClockUs response
+    quint32 low_;
+};
@@ -27,7 +27,9 @@
 MainWindow::MainWindow(AttributeType *cfg) :
     QMainWindow(nullptr),
     serial_(new SerialWidget(this, cfg)),
-    tabWindow_(new TabWindow(this, serial_, cfg))   
+    tabWindow_(new TabWindow(this, serial_, cfg)),
+    trace_(new TraceExport(this)),
+    clock_(new ClockSync(this))
 {
     Config_.clone(cfg);
 
@@ -69,6 +71,22 @@ MainWindow::MainWindow(AttributeType *cfg) :
             this, &MainWindow::slotTextToStatusBar);
     connect(tabWindow_, &TabWindow::signalTextToStatusBar,
             this, &MainWindow::slotTextToStatusBar);
+    connect(trace_, &TraceExport::signalTextToStatusBar,
+            this, &MainWindow::slotTextToStatusBar);
+
+    // Save 'trace:Dump' output as a timeline JSON file
+    connect(serial_, &SerialWidget::signalRecvSerialPort,
+            trace_, &TraceExport::slotRecvData);
+
+    // Target to host time mapping
+    connect(serial_, &SerialWidget::signalSerialPortOpened,
+            clock_, &ClockSync::slotSerialPortOpened);
+    connect(serial_, &SerialWidget::signalSerialPortClosed,
+            clock_, &ClockSync::slotSerialPortClosed);
+    connect(serial_, &SerialWidget::signalResponseReadAttribute,
+            clock_, &ClockSync::slotResponseAttribute);
+    connect(clock_, &ClockSync::signalRequestReadAttribute,
+            serial_, &SerialWidget::slotRequestReadAttribute);
 
     openSerialPort();
 }
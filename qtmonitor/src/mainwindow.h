@@ -20,6 +20,8 @@
 #include <QStatusBar>
 #include "tabwindow.h"
 #include "serial.h"
+#include "traceexport.h"
+#include "clocksync.h"
 #include "dlg/dlgserialsettings.h"
 
 class MainWindow : public QMainWindow
@@ -43,6 +45,8 @@ class MainWindow : public QMainWindow
 
     SerialWidget *serial_;
     TabWindow *tabWindow_;
+    TraceExport *trace_;
+    ClockSync *clock_;
     QLabel *labelStatus_[2];
     DialogSerialSettings *dialogSerialSettings_;
 
@@ -15,6 +15,7 @@
  */
 
 #include "serial.h"
+#include <QRegularExpression>
 
 SerialWidget::SerialWidget(QObject *parent, AttributeType *cfg) :
     QSerialPort(parent),
@@ -23,6 +24,8 @@ SerialWidget::SerialWidget(QObject *parent, AttributeType *cfg) :
     ObjectsList_ = (*cfg)["TargetConfig"]["ObjectsList"];
     bytesToWrite_ = 0;
     eframestate_ = State_PRM1;
+    cfgActive_ = false;
+    layoutValid_ = false;
 
     timer_.setSingleShot(true);
 
@@ -47,6 +50,13 @@ bool SerialWidget::open(OpenMode mode) {
                 settings_.name.toUtf8().constBegin(), settings_.baudRate);
         emit signalSerialPortOpened();
         emit signalTextToStatusBar(0, text);
+
+        // Attributes list of the firmware defines the packed layout,
+        // kernel is the object 0 with the attribute 0 in any firmware
+        layoutValid_ = false;
+        cfgActive_ = false;
+        cfgline_.clear();
+        slotSendSerialPort(QByteArray(">!00000000,1,00\r\n"));
     } else {
         const QString error = QString::asprintf("Open error %s",
                 settings_.name.toUtf8().constBegin());
@@ -248,38 +258,252 @@ void SerialWidget::slotRecvSerialPort() {
     }
 
     if (raw.size()) {
+        processConfigText(raw);
         emit signalRecvSerialPort(raw);
     }
 }
 
+void SerialWidget::processConfigText(const QByteArray &data) {
+    for (auto &s : data) {
+        if (s == '\r') {
+            continue;
+        }
+        if (s != '\n') {
+            cfgline_ += s;
+            continue;
+        }
+        processConfigLine(QString::fromLatin1(cfgline_));
+        cfgline_.clear();
+    }
+}
+
+/**
+ * @brief Lines of KernelClassGeneric::TargetConfigAttribute::pre_read(),
+ *        only indexes, names and types are used.
+ */
+void SerialWidget::processConfigLine(const QString &line) {
+    static const QRegularExpression reAtr(
+        "^\\s*\\{'Index':(\\d+), 'Name':'([^']*)', 'Type':'([^']*)'"
+        "(?:, 'Pack':(\\d))?");
+    static const QRegularExpression reObj(
+        "^\\s*\\{'Index':(\\d+), 'Name':'([^']*)',$");
+    QRegularExpressionMatch m;
+
+    if (line.startsWith("'TargetConfig':{")) {
+        cfgActive_ = true;
+        targetObjects_.make_list(0);
+        return;
+    }
+    if (!cfgActive_) {
+        return;
+    }
+
+    if ((m = reAtr.match(line)).hasMatch()) {
+        if (targetObjects_.size() == 0) {
+            return;
+        }
+        AttributeType &obj = targetObjects_[targetObjects_.size() - 1];
+        AttributeType &atr = obj["Attributes"].new_list_item();
+        atr.make_dict();
+        atr["Index"].make_int64(m.captured(1).toInt());
+        atr["Name"].make_string(m.captured(2).toLatin1().constData());
+        atr["Type"].make_string(m.captured(3).toLatin1().constData());
+        if (m.captured(4).size()) {
+            atr["Pack"].make_int64(m.captured(4).toInt());
+        }
+    } else if ((m = reObj.match(line)).hasMatch()) {
+        AttributeType &obj = targetObjects_.new_list_item();
+        obj.make_dict();
+        obj["Index"].make_int64(m.captured(1).toInt());
+        obj["Name"].make_string(m.captured(2).toLatin1().constData());
+        obj["Attributes"].make_list(0);
+    } else if (line == "}") {
+        cfgActive_ = false;
+        ObjectsList_ = targetObjects_;
+        layoutValid_ = true;
+        emit signalTextToStatusBar(0, QString::asprintf(
+                "Target config: %u objects", ObjectsList_.size()));
+    }
+}
+
 void SerialWidget::processRxCanFrame(can_frame_type *frame) {
     QString objname = tr("none");
     QString atrname = tr("none");
     QString type = tr("");
     quint32 data = static_cast<quint32>(frame->data.u64 >> 8);
 
+    if (frame->data.u8[0] & DBC_PACK_MUX) {
+        processPackedFrame(frame);
+        return;
+    }
+
     idx2names(frame->id, objname, frame->data.u8[0] & 0x7F, atrname, type);
+    if (type != "") {
+        data = decodeValue(type, &frame->data.u8[1]);
+    }
+
+    emit signalResponseReadAttribute(objname, atrname, data);
+}
+
+/**
+ * @brief Little-endian value of the attribute at the payload position
+ */
+quint32 SerialWidget::decodeValue(const QString &type, const quint8 *buf) {
+    quint32 data = 0;
     if (type == "uint8") {
-        data = frame->data.u8[1];
+        data = buf[0];
     } else if (type == "int8") {
-        data = frame->data.s8[1];
+        data = static_cast<quint32>(static_cast<qint8>(buf[0]));
     } else if (type == "uint16") {
-        data = frame->data.u8[2];
-        data = (data << 8) | frame->data.u8[1];
+        data = buf[1];
+        data = (data << 8) | buf[0];
     } else if (type == "int16") {
-        data = frame->data.u8[2];
-        data = (data << 8) | frame->data.u8[1];
+        data = buf[1];
+        data = (data << 8) | buf[0];
         if (data & 0x8000) {
             data |= 0xFFFF0000;
         }
-    } else if (type == "uint32" || type == "int32") {
-        data = frame->data.u8[4];
-        data = (data << 8) | frame->data.u8[3];
-        data = (data << 8) | frame->data.u8[2];
-        data = (data << 8) | frame->data.u8[1];
+    } else {
+        // 32-bits values and the lower half of 64-bits values
+        data = buf[3];
+        data = (data << 8) | buf[2];
+        data = (data << 8) | buf[1];
+        data = (data << 8) | buf[0];
     }
+    return data;
+}
 
-    emit signalResponseReadAttribute(objname, atrname, data);
+/**
+ * @brief The same as FwAttribute::BitSize() of FW, zero for the kinds that
+ *        are never packed (FwAttribute::isPackable())
+ */
+int SerialWidget::type2bits(const QString &type) {
+    if (type == "int8" || type == "uint8") {
+        return 8;
+    } else if (type == "int16" || type == "uint16") {
+        return 16;
+    } else if (type == "int32" || type == "uint32" || type == "float") {
+        return 32;
+    } else if (type == "int64" || type == "uint64" || type == "double") {
+        return 64;
+    }
+    return 0;
+}
+
+int SerialWidget::packLayout(const AttributeType &obj, DbcPackLayout *layout) {
+    quint8 order[DBC_PACK_ATTR_MAX];
+    int total = 0;
+    int bits;
+    int a;
+    int k;
+    int p;
+
+    // Attributes are indexed by 'Index' field as in FW
+    for (a = 0; a < DBC_PACK_ATTR_MAX; a++) {
+        layout->bitsz[a] = 0;
+        layout->page[a] = DBC_PACK_NONE;
+        layout->startbit[a] = 0;
+    }
+    for (unsigned n = 0; n < obj["Attributes"].size(); n++) {
+        const AttributeType &atr = obj["Attributes"][n];
+        a = atr["Index"].to_int();
+        if (a < 0 || a >= DBC_PACK_ATTR_MAX) {
+            continue;
+        }
+        // Attributes with hooks are not packed, see 'Pack' of TargetConfig
+        bits = 0;
+        if (!atr.has_key("Pack") || atr["Pack"].to_int() != 0) {
+            bits = type2bits(QString(atr["Type"].to_string()));
+        }
+        if (bits > DBC_PACK_PAYLOAD_BITS) {
+            bits = DBC_PACK_PAYLOAD_BITS;
+        }
+        layout->bitsz[a] = static_cast<quint8>(bits);
+        if (total < a + 1) {
+            total = a + 1;
+        }
+    }
+    layout->total = total;
+    layout->pages = 0;
+
+    // Stable insertion sort by decreasing size
+    for (a = 0; a < total; a++) {
+        bits = layout->bitsz[a];
+        for (k = a; k > 0 && layout->bitsz[order[k - 1]] < bits; k--) {
+            order[k] = order[k - 1];
+        }
+        order[k] = static_cast<quint8>(a);
+    }
+
+    for (k = 0; k < total; k++) {
+        a = order[k];
+        bits = layout->bitsz[a];
+        if (bits == 0) {
+            continue;
+        }
+        for (p = 0; p < layout->pages; p++) {
+            if (layout->pagebits[p] + bits <= DBC_PACK_PAYLOAD_BITS) {
+                break;
+            }
+        }
+        if (p == layout->pages) {
+            if (p == DBC_PACK_PAGES_MAX) {
+                continue;
+            }
+            layout->pagebits[layout->pages++] = 0;
+        }
+        layout->page[a] = static_cast<quint8>(p);
+        layout->startbit[a] = static_cast<quint8>(8 + layout->pagebits[p]);
+        layout->pagebits[p] += static_cast<quint8>(bits);
+    }
+    return layout->pages;
+}
+
+/**
+ * @brief Unpack all attributes of the page: [6] of the multiplexor is set
+ *        and [5:0] is the page index.
+ */
+void SerialWidget::processPackedFrame(can_frame_type *frame) {
+    DbcPackLayout layout;
+    int page = frame->data.u8[0] & (DBC_PACK_MUX - 1);
+    int pos;
+
+    // Layout of the config file could be stale: every signal moves
+    if (!layoutValid_) {
+        return;
+    }
+
+    for (unsigned i = 0; i < ObjectsList_.size(); i++) {
+        const AttributeType &obj = ObjectsList_[i];
+        if (obj["Index"].to_int() != static_cast<int>(frame->id & 0xFF)) {
+            continue;
+        }
+        QString objname(obj["Name"].to_string());
+        if (page >= packLayout(obj, &layout)
+            || frame->dlc != 1 + layout.pagebits[page] / 8) {
+            // The same size as DbcConverter::encodePackedPage() forms
+            emit signalTextToStatusBar(0, QString::asprintf(
+                    "DBC page %d of %s does not match the target config",
+                    page, objname.toUtf8().constData()));
+            return;
+        }
+        for (unsigned n = 0; n < obj["Attributes"].size(); n++) {
+            const AttributeType &atr = obj["Attributes"][n];
+            int a = atr["Index"].to_int();
+            if (a < 0 || a >= DBC_PACK_ATTR_MAX || layout.page[a] != page) {
+                continue;
+            }
+            pos = layout.startbit[a] / 8;
+            if (pos + layout.bitsz[a] / 8 > frame->dlc) {
+                continue;
+            }
+            QString type(atr["Type"].to_string());
+            emit signalResponseReadAttribute(objname,
+                                             QString(atr["Name"].to_string()),
+                                             decodeValue(type, &frame->data.u8[pos]));
+        }
+        return;
+    }
 }
 
 void SerialWidget::slotBytesWritten(qint64 bytes) {
@@ -36,6 +36,25 @@ typedef struct can_frame_type {
     can_payload_type data;
 } can_frame_type;
 
+/**
+ * @brief Attributes placement in the packed DBC messages, the same
+ *        first-fit decreasing layout as DbcConverter::packLayout() of FW
+ */
+static const int DBC_PACK_ATTR_MAX = 64;
+static const int DBC_PACK_PAGES_MAX = 64;
+static const int DBC_PACK_PAYLOAD_BITS = 56;
+static const quint8 DBC_PACK_MUX = 0x40;
+static const quint8 DBC_PACK_NONE = 0xFF;
+
+typedef struct DbcPackLayout {
+    int total;
+    int pages;
+    quint8 page[DBC_PACK_ATTR_MAX];
+    quint8 startbit[DBC_PACK_ATTR_MAX];
+    quint8 bitsz[DBC_PACK_ATTR_MAX];
+    quint8 pagebits[DBC_PACK_PAGES_MAX];
+} DbcPackLayout;
+
 class SerialWidget : public QSerialPort {
     Q_OBJECT
 
@@ -75,9 +94,21 @@ class SerialWidget : public QSerialPort {
     QString names2request(const QString &objname, const QString &atrname, quint32 data);
 
     void processRxCanFrame(can_frame_type *frame);
+    void processPackedFrame(can_frame_type *frame);
+    void processConfigText(const QByteArray &data);
+    void processConfigLine(const QString &line);
+    quint32 decodeValue(const QString &type, const quint8 *buf);
+    int type2bits(const QString &type);
+    int packLayout(const AttributeType &obj, DbcPackLayout *layout);
 
  private:
     AttributeType ObjectsList_;
+    // 'kernel:TargetConfig' output of the connected target replaces the
+    // ObjectsList of the config file, packed pages are decoded only then
+    AttributeType targetObjects_;
+    QByteArray cfgline_;
+    bool cfgActive_;
+    bool layoutValid_;
     QTimer timer_;
     qint64 bytesToWrite_;
     SerialPortSettings settings_;
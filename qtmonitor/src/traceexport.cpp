@@ -0,0 +1,196 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "traceexport.h"
+#include <QRegularExpression>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QFile>
+#include <QSet>
+
+TraceExport::TraceExport(QObject *parent) :
+    QObject(parent),
+    active_(false),
+    cpuHz_(0),
+    overrun_(0) {
+}
+
+void TraceExport::slotRecvData(const QByteArray &data) {
+    for (auto &s : data) {
+        if (s == '\r') {
+            continue;
+        }
+        if (s != '\n') {
+            line_ += s;
+            continue;
+        }
+        processLine(QString::fromLatin1(line_));
+        line_.clear();
+    }
+}
+
+void TraceExport::processLine(const QString &line) {
+    static const QRegularExpression reHdr("'Trace':\\{'CpuHz':(\\d+), 'Overrun':(\\d+)");
+    static const QRegularExpression reTask("'([^']*)'");
+    static const QRegularExpression reEvent("\\[0x([0-9a-fA-F]+),(\\d+),(\\d+),(\\d+)\\]");
+    QRegularExpressionMatch m = reHdr.match(line);
+
+    if (m.hasMatch()) {
+        active_ = true;
+        cpuHz_ = m.captured(1).toUInt();
+        overrun_ = m.captured(2).toUInt();
+        tasks_.clear();
+        ts_.clear();
+        word_.clear();
+        return;
+    }
+    if (!active_) {
+        return;
+    }
+
+    if (line.contains("'Tasks':[")) {
+        QRegularExpressionMatchIterator it = reTask.globalMatch(line);
+        it.next();      // skip 'Tasks' key
+        while (it.hasNext()) {
+            tasks_.append(it.next().captured(1));
+        }
+    } else if ((m = reEvent.match(line)).hasMatch()) {
+        ts_.append(m.captured(1).toUInt(nullptr, 16));
+        word_.append(m.captured(2).toUInt()
+                    | (m.captured(3).toUInt() << 8)
+                    | (m.captured(4).toUInt() << 16));
+    } else if (line.startsWith("]}")) {
+        active_ = false;
+        save();
+    }
+}
+
+void TraceExport::addEvent(const char *ph, int pid, int tid,
+                           const QString &name, double us) {
+    QJsonObject e;
+    e["name"] = name;
+    e["ph"] = ph;
+    e["pid"] = pid;
+    e["tid"] = tid;
+    e["ts"] = us;
+    if (ph[0] == 'i') {
+        e["s"] = "t";
+    }
+    events_.append(e);
+}
+
+void TraceExport::addName(int pid, int tid, const QString &name) {
+    QJsonObject e;
+    QJsonObject args;
+    args["name"] = name;
+    e["name"] = tid < 0 ? "process_name" : "thread_name";
+    e["ph"] = "M";
+    e["pid"] = pid;
+    e["tid"] = tid < 0 ? 0 : tid;
+    e["args"] = args;
+    events_.append(e);
+}
+
+/**
+ * DWT counter is 32-bits and wraps around in several seconds, the full time
+ * is restored assuming that the distance between neighbour events is less
+ * than the wrap period.
+ */
+void TraceExport::save() {
+    quint64 t64 = 0;
+    double us;
+    int task = 0;
+    int irq[IRQ_NESTING_MAX];
+    int irqcnt = 0;
+    QSet<int> irqnames;
+
+    events_ = QJsonArray();
+    if (ts_.size() == 0 || cpuHz_ == 0) {
+        emit signalTextToStatusBar(0, "Trace is empty");
+        return;
+    }
+
+    addName(PID_TASKS, -1, "Tasks");
+    addName(PID_IRQ, -1, "Interrupts");
+    for (int i = 0; i < tasks_.size(); i++) {
+        addName(PID_TASKS, i + 1, tasks_[i]);
+    }
+
+    for (int i = 0; i < ts_.size(); i++) {
+        if (i) {
+            t64 += static_cast<quint32>(ts_[i] - ts_[i - 1]);
+        }
+        us = static_cast<double>(t64) * 1000000.0 / cpuHz_;
+        int type = word_[i] & 0xFF;
+        int id = (word_[i] >> 8) & 0xFF;
+        int arg = word_[i] >> 16;
+        QString qname = QString::asprintf("q_%04x(%d)", arg, id);
+
+        switch (type) {
+        case Event_TaskIn:
+            if (task) {
+                addEvent("E", PID_TASKS, task, "", us);
+            }
+            task = id;
+            addEvent("B", PID_TASKS, task, "run", us);
+            break;
+        case Event_QueueSend:
+            addEvent("i", PID_TASKS, task, "send " + qname, us);
+            break;
+        case Event_QueueRecv:
+            addEvent("i", PID_TASKS, task, "recv " + qname, us);
+            break;
+        case Event_QueueSendIsr:
+        case Event_QueueRecvIsr:
+            addEvent("i", PID_IRQ, irqcnt ? irq[irqcnt - 1] : 0,
+                     (type == Event_QueueSendIsr ? "send " : "recv ") + qname, us);
+            break;
+        case Event_IsrEnter:
+            if (!irqnames.contains(id)) {
+                irqnames.insert(id);
+                addName(PID_IRQ, id, QString::asprintf("IRQ %d", id));
+            }
+            if (irqcnt < IRQ_NESTING_MAX) {
+                irq[irqcnt++] = id;
+            }
+            addEvent("B", PID_IRQ, id, QString::asprintf("IRQ %d", id), us);
+            break;
+        case Event_IsrExit:
+            if (irqcnt) {
+                irqcnt--;
+            }
+            addEvent("E", PID_IRQ, id, "", us);
+            break;
+        default:;
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events_;
+    root["displayTimeUnit"] = "ns";
+    QString fname = QDateTime::currentDateTime().toString("'trace_'yyyyMMdd_hhmmss'.json'");
+    QFile file(fname);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit signalTextToStatusBar(0, "Cannot write " + fname);
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.close();
+    emit signalTextToStatusBar(0, QString::asprintf("Trace saved to %s: %d events, %d lost",
+                    fname.toUtf8().constBegin(),
+                    static_cast<int>(ts_.size()), static_cast<int>(overrun_)));
+}
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2024 Sergey Khabarov, sergeykhbr@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QStringList>
+#include <QJsonArray>
+
+/**
+ * @brief Catch the output of the 'trace:Dump' attribute in the console
+ *        stream and save it as Chrome trace JSON file that can be opened
+ *        in chrome://tracing or ui.perfetto.dev. Tasks and interrupts are
+ *        shown as separate processes, queue operations as instant events.
+ */
+class TraceExport : public QObject {
+    Q_OBJECT
+
+ public:
+    explicit TraceExport(QObject *parent = nullptr);
+
+ signals:
+    void signalTextToStatusBar(qint32 idx, const QString &text);
+
+ public slots:
+    void slotRecvData(const QByteArray &data);
+
+ private:
+    void processLine(const QString &line);
+    void save();
+    void addEvent(const char *ph, int pid, int tid, const QString &name, double us);
+    void addName(int pid, int tid, const QString &name);
+
+ private:
+    // Event types, the same as EFwTraceEvent in fwtrace.h
+    enum EEventType {
+        Event_TaskIn = 1,
+        Event_QueueSend,
+        Event_QueueRecv,
+        Event_QueueSendIsr,
+        Event_QueueRecvIsr,
+        Event_IsrEnter,
+        Event_IsrExit
+    };
+    static const int PID_TASKS = 1;
+    static const int PID_IRQ = 2;
+    static const int IRQ_NESTING_MAX = 16;
+
+    QByteArray line_;
+    bool active_;
+    quint32 cpuHz_;
+    quint32 overrun_;
+    QStringList tasks_;
+    QList<quint32> ts_;
+    QList<quint32> word_;       // [7:0] type, [15:8] id, [31:16] arg
+    QJsonArray events_;
+};